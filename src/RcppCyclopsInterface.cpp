@@ -18,6 +18,7 @@
 #include "io/OutputWriter.h"
 #include "RcppOutputHelper.h"
 #include "RcppProgressLogger.h"
+#include "boost/iterator/counting_iterator.hpp"
 #include "priors/NewCovariatePrior.h"
 
 // Rcpp export code
@@ -145,6 +146,15 @@ void cyclopsSetCensorWeights(SEXP inRcppCcdInterface,
     interface->getCcd().setCensorWeights(&weights[0]);
 }
 
+// [[Rcpp::export(".cyclopsSetFineGrayCensorWeights")]]
+void cyclopsSetFineGrayCensorWeights(SEXP inRcppCcdInterface) {
+    using namespace bsccs;
+    XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+    std::vector<double> weights = interface->getModelData().getFineGrayCensoringWeights();
+    interface->getCcd().setCensorWeights(weights.data());
+}
+
 // [[Rcpp::export(".cyclopsGetPredictiveLogLikelihood")]]
 double cyclopsGetPredictiveLogLikelihood(SEXP inRcppCcdInterface,
     NumericVector& weights) {
@@ -173,6 +183,41 @@ double cyclopsGetLogLikelihood(SEXP inRcppCcdInterface) {
 	return interface->getCcd().getLogLikelihood();
 }
 
+// [[Rcpp::export(".cyclopsGetLogLikelihoodGradient")]]
+List cyclopsGetLogLikelihoodGradient(SEXP inRcppCcdInterface) {
+	using namespace bsccs;
+	XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+	std::vector<double> gradient;
+	const double logLikelihood = interface->getCcd().getLogLikelihoodGradient(gradient);
+	if (interface->getModelData().getHasOffsetCovariate()) {
+		gradient.erase(gradient.begin());
+	}
+
+	return List::create(
+		Named("logLikelihood") = logLikelihood,
+		Named("gradient") = gradient
+	);
+}
+
+// [[Rcpp::export(".cyclopsGetHessianVectorProduct")]]
+std::vector<double> cyclopsGetHessianVectorProduct(SEXP inRcppCcdInterface, std::vector<double> vector) {
+	using namespace bsccs;
+	XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+	const bool hasOffset = interface->getModelData().getHasOffsetCovariate();
+	if (hasOffset) {
+		vector.insert(vector.begin(), 0.0); // Offset coefficient is fixed
+	}
+
+	std::vector<double> product;
+	interface->getCcd().getLogLikelihoodHessianVectorProduct(vector, product);
+	if (hasOffset) {
+		product.erase(product.begin());
+	}
+	return product;
+}
+
 // [[Rcpp::export(".cyclopsGetFisherInformation")]]
 Eigen::MatrixXd cyclopsGetFisherInformation(SEXP inRcppCcdInterface, const SEXP sexpCovariates) {
 	using namespace bsccs;
@@ -353,6 +398,33 @@ DataFrame cyclopsGetProfileLikelihood(SEXP inRcppCcdInterface,
     );
 }
 
+// [[Rcpp::export(".cyclopsGetAdaptiveProfileLikelihood")]]
+DataFrame cyclopsGetAdaptiveProfileLikelihood(SEXP inRcppCcdInterface,
+                                              SEXP inCovariate,
+                                              const std::vector<double> bounds,
+                                              int initialGridSize, double tolerance,
+                                              double threshold,
+                                              int threads, bool includePenalty) {
+    using namespace bsccs;
+    XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+    const IdType covariate = as<IdType>(inCovariate);
+
+    if (bounds.size() != 2) {
+        Rcpp::stop("Bounds must have length 2");
+    }
+
+    std::vector<double> points;
+    std::vector<double> values;
+    interface->evaluateProfileModel(covariate, bounds[0], bounds[1], initialGridSize, tolerance,
+                                    threshold, points, values, threads, includePenalty);
+
+    return DataFrame::create(
+        Rcpp::Named("point") = points,
+        Rcpp::Named("value") = values
+    );
+}
+
 // [[Rcpp::export(".cyclopsProfileModel")]]
 List cyclopsProfileModel(SEXP inRcppCcdInterface, SEXP sexpCovariates, int threads, double threshold,
 		bool override, bool includePenalty) {
@@ -401,13 +473,32 @@ List cyclopsPredictModel(SEXP inRcppCcdInterface) {
 }
 
 
+// [[Rcpp::export(".cyclopsGetBaselineHazard")]]
+List cyclopsGetBaselineHazard(SEXP inRcppCcdInterface) {
+    using namespace bsccs;
+    XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+    std::vector<double> time;
+    std::vector<double> hazard;
+    std::vector<int> stratum;
+    interface->getCcd().getBaselineHazard(time, hazard, stratum);
+
+    return List::create(
+        Rcpp::Named("time") = time,
+        Rcpp::Named("cumulativeHazard") = hazard,
+        Rcpp::Named("stratum") = stratum
+    );
+}
+
 // [[Rcpp::export(".cyclopsSetControl")]]
 void cyclopsSetControl(SEXP inRcppCcdInterface,
 		int maxIterations, double tolerance, const std::string& convergenceType,
 		bool useAutoSearch, int fold, int foldToCompute, double lowerLimit, double upperLimit, int gridSteps,
 		const std::string& noiseLevel, int threads, int seed, bool resetCoefficients, double startingVariance,
         bool useKKTSwindle, int swindleMultipler, const std::string& selectorType, double initialBound,
-        int maxBoundCount, const std::string& algorithm
+        int maxBoundCount, const std::string& algorithm, bool useBatchSearch, bool useProfiler,
+        int convergenceTrace, bool threadAffinity, int newtonMaxCovariates, int stationaryCycles,
+        const std::string& checkpointFile, int checkpointInterval
 		) {
 	using namespace bsccs;
 	XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
@@ -422,10 +513,19 @@ void cyclopsSetControl(SEXP inRcppCcdInterface,
     args.modeFinding.maxBoundCount = maxBoundCount;
     if (algorithm == "mm") {
         args.modeFinding.algorithmType = AlgorithmType::MM;
+    } else if (algorithm == "newton") {
+        args.modeFinding.algorithmType = AlgorithmType::NEWTON;
+    } else if (algorithm == "lbfgs") {
+        args.modeFinding.algorithmType = AlgorithmType::LBFGS;
+    } else if (algorithm == "shotgun") {
+        args.modeFinding.algorithmType = AlgorithmType::SHOTGUN;
     }
+    args.modeFinding.newtonMaxCovariates = newtonMaxCovariates;
+    args.modeFinding.stationaryCycles = stationaryCycles;
 
 	// Cross validation control
 	args.crossValidation.useAutoSearchCV = useAutoSearch;
+	args.crossValidation.useBatchSearch = useBatchSearch;
 	args.crossValidation.fold = fold;
 	args.crossValidation.foldToCompute = foldToCompute;
 	args.crossValidation.lowerLimit = lowerLimit;
@@ -433,6 +533,8 @@ void cyclopsSetControl(SEXP inRcppCcdInterface,
 	args.crossValidation.gridSteps = gridSteps;
 	args.crossValidation.startingVariance = startingVariance;
 	args.crossValidation.selectorType = RcppCcdInterface::parseSelectorType(selectorType);
+	args.crossValidation.checkpointFileName = checkpointFile;
+	args.crossValidation.checkpointInterval = checkpointInterval;
 
 	NoiseLevels noise = RcppCcdInterface::parseNoiseLevel(noiseLevel);
 	args.noiseLevel = noise;
@@ -440,6 +542,106 @@ void cyclopsSetControl(SEXP inRcppCcdInterface,
 	args.threads = threads;
 	args.seed = seed;
 	args.resetCoefficients = resetCoefficients;
+
+	// Engine phase timing
+	interface->getCcd().setProfiling(useProfiler);
+
+	// Per-iteration convergence records
+	interface->getCcd().setConvergenceTrace(convergenceTrace);
+
+	// Worker placement
+	if (auto pool = interface->getCcd().getWorkerPool()) {
+		pool->setAffinity(threadAffinity);
+	}
+}
+
+// [[Rcpp::export(".cyclopsGetSolverState")]]
+Rcpp::RawVector cyclopsGetSolverState(SEXP inRcppCcdInterface) {
+    using namespace bsccs;
+    XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+    std::ostringstream stream(std::ios::binary);
+    interface->getCcd().writeState(stream);
+    const std::string bytes = stream.str();
+    return Rcpp::RawVector(bytes.begin(), bytes.end());
+}
+
+// [[Rcpp::export(".cyclopsSetSolverState")]]
+void cyclopsSetSolverState(SEXP inRcppCcdInterface, Rcpp::RawVector state) {
+    using namespace bsccs;
+    XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+    std::istringstream stream(std::string(state.begin(), state.end()), std::ios::binary);
+    interface->getCcd().readState(stream);
+}
+
+// [[Rcpp::export(".cyclopsUpdateForAppendedData")]]
+bool cyclopsUpdateForAppendedData(SEXP inRcppCcdInterface) {
+    using namespace bsccs;
+    XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+    return interface->getCcd().updateForAppendedData();
+}
+
+// [[Rcpp::export(".cyclopsGetConvergenceTrace")]]
+DataFrame cyclopsGetConvergenceTrace(SEXP inRcppCcdInterface) {
+    using namespace bsccs;
+    XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+    const auto entries = interface->getCcd().getConvergenceTrace();
+    const size_t n = entries.size();
+    IntegerVector iteration(n), activeSize(n), updateCount(n);
+    NumericVector objective(n), criterion(n), logLikelihood(n), logPrior(n), maxAbsDelta(n), seconds(n);
+    for (size_t i = 0; i < n; ++i) {
+        const auto& entry = entries[i];
+        iteration[i] = entry.iteration;
+        objective[i] = entry.objective;
+        criterion[i] = entry.criterion;
+        logLikelihood[i] = entry.logLikelihood;
+        logPrior[i] = entry.logPrior;
+        maxAbsDelta[i] = entry.maxAbsDelta;
+        activeSize[i] = entry.activeSize;
+        updateCount[i] = entry.updateCount;
+        seconds[i] = entry.seconds;
+    }
+
+    return DataFrame::create(
+        Rcpp::Named("iteration") = iteration,
+        Rcpp::Named("objective") = objective,
+        Rcpp::Named("criterion") = criterion,
+        Rcpp::Named("logLikelihood") = logLikelihood,
+        Rcpp::Named("logPrior") = logPrior,
+        Rcpp::Named("maxAbsDelta") = maxAbsDelta,
+        Rcpp::Named("activeSize") = activeSize,
+        Rcpp::Named("updateCount") = updateCount,
+        Rcpp::Named("seconds") = seconds
+    );
+}
+
+// [[Rcpp::export(".cyclopsGetProfile")]]
+DataFrame cyclopsGetProfile(SEXP inRcppCcdInterface) {
+    using namespace bsccs;
+    XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+    const auto entries = interface->getCcd().getProfile();
+    std::vector<std::string> phase;
+    std::vector<std::string> format;
+    std::vector<double> calls;
+    std::vector<double> seconds;
+    for (const auto& entry : entries) {
+        phase.push_back(entry.phase);
+        format.push_back(entry.format);
+        calls.push_back(static_cast<double>(entry.calls));
+        seconds.push_back(entry.nanoseconds * 1E-9);
+    }
+
+    return DataFrame::create(
+        Rcpp::Named("phase") = phase,
+        Rcpp::Named("format") = format,
+        Rcpp::Named("calls") = calls,
+        Rcpp::Named("seconds") = seconds,
+        Rcpp::Named("stringsAsFactors") = false
+    );
 }
 
 // [[Rcpp::export(".cyclopsRunCrossValidation")]]
@@ -477,6 +679,225 @@ List cyclopsFitModel(SEXP inRcppCcdInterface) {
 	return list;
 }
 
+static void getEstimates(bsccs::CyclicCoordinateDescent& ccd, const bsccs::AbstractModelData& data,
+                         std::vector<double>& labels, std::vector<double>& values) {
+    const auto& collapsedIndex = data.getCollapsedIndex();
+    if (collapsedIndex.empty()) {
+        auto index = data.getHasOffsetCovariate() ? 1 : 0;
+        for ( ; index < ccd.getBetaSize(); ++index) {
+            labels.push_back(data.getColumnNumericalLabel(index));
+            values.push_back(ccd.getBeta(index));
+        }
+    } else {
+        // Expand collapsed duplicates; identical covariates share their column's estimate equally
+        const auto& collapsedLabels = data.getCollapsedLabels();
+        const auto& multiplicity = data.getColumnMultiplicity();
+        for (size_t i = 0; i < collapsedIndex.size(); ++i) {
+            const int index = collapsedIndex[i];
+            labels.push_back(collapsedLabels[i]);
+            values.push_back(ccd.getBeta(index) / multiplicity[index]);
+        }
+    }
+}
+
+// [[Rcpp::export(".cyclopsFitOutcomes")]]
+List cyclopsFitOutcomes(SEXP inRcppCcdInterface, const NumericMatrix& outcomes) {
+	using namespace bsccs;
+
+	XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+	auto& ccd = interface->getCcd();
+	auto& data = interface->getModelData();
+
+	if (!data.getRowMultiplicity().empty()) {
+	    Rcpp::stop("Outcomes cannot be replaced after identical rows are compressed");
+	}
+	if (static_cast<size_t>(outcomes.nrow()) != data.getNumberOfRows()) {
+	    Rcpp::stop("Must provide an outcome for each data row");
+	}
+
+	// Every outcome starts from the current coefficients, so fits do not depend on their order
+	const std::vector<double> original = data.copyYVector();
+	std::vector<double> start(ccd.getBetaSize());
+	for (int j = 0; j < ccd.getBetaSize(); ++j) {
+	    start[j] = ccd.getBeta(j);
+	}
+
+	const int nOutcomes = outcomes.ncol();
+	std::vector<double> labels;
+	NumericVector estimates;
+	NumericVector logLikelihood(nOutcomes);
+	IntegerVector iterations(nOutcomes);
+	CharacterVector returnFlag(nOutcomes);
+	LogicalVector converged(nOutcomes);
+
+	std::vector<double> y(outcomes.nrow());
+	for (int m = 0; m < nOutcomes; ++m) {
+	    std::copy(outcomes.column(m).begin(), outcomes.column(m).end(), y.begin());
+	    data.setYVector(y);
+	    ccd.setBeta(start);
+
+	    interface->fitModel();
+
+	    std::vector<double> values;
+	    labels.clear();
+	    getEstimates(ccd, data, labels, values);
+	    if (m == 0) {
+	        estimates = NumericVector(values.size() * nOutcomes);
+	    }
+	    std::copy(values.begin(), values.end(), estimates.begin() + m * values.size());
+
+	    const auto flag = ccd.getUpdateReturnFlag();
+	    logLikelihood[m] = ccd.getLogLikelihood();
+	    iterations[m] = ccd.getIterationCount();
+	    returnFlag[m] = DiagnosticsOutputWriter(ccd, data).returnFlagString(flag);
+	    converged[m] = (flag == SUCCESS);
+	}
+
+	data.setYVector(original);
+	ccd.setBeta(start);
+
+	if (nOutcomes > 0) {
+	    estimates.attr("dim") = Dimension(labels.size(), nOutcomes);
+	}
+
+	return List::create(
+	    Named("column_label") = labels,
+	    Named("estimates") = estimates,
+	    Named("log_likelihood") = logLikelihood,
+	    Named("iterations") = iterations,
+	    Named("return_flag") = returnFlag,
+	    Named("converged") = converged
+	);
+}
+
+// [[Rcpp::export(".cyclopsFitModels")]]
+List cyclopsFitModels(SEXP inRcppCcdInterface, const List& modelData,
+                      const std::vector<std::string>& priorTypeName,
+                      const std::vector<double>& variance,
+                      const List& exclude, bool computeSEs) {
+	using namespace bsccs;
+
+	// Control arguments and worker threads come from an already configured interface
+	XPtr<RcppCcdInterface> templateInterface(inRcppCcdInterface);
+	const CCDArguments& arguments = templateInterface->getArguments();
+	const int nThreads = std::max(arguments.threads, 1);
+
+	const int nModels = modelData.size();
+	if (exclude.size() != nModels) {
+	    Rcpp::stop("Must provide excluded covariates for each model");
+	}
+
+	struct Fit {
+	    std::vector<double> labels;
+	    std::vector<double> estimates;
+	    std::vector<double> standardErrors;
+	    double logLikelihood;
+	    int iterations;
+	    std::string returnFlag;
+	};
+	std::vector<Fit> fits(nModels);
+
+	// Models are built and released on this thread in waves, so only a few are held at a time
+	const int waveSize = nThreads * 8;
+	for (int waveStart = 0; waveStart < nModels; waveStart += waveSize) {
+	    const int waveEnd = std::min(waveStart + waveSize, nModels);
+
+	    std::vector<std::unique_ptr<RcppCcdInterface>> wave;
+	    for (int i = waveStart; i < waveEnd; ++i) {
+	        XPtr<AbstractModelData> data(modelData[i]);
+	        wave.emplace_back(new RcppCcdInterface(*data));
+	        auto& interface = *wave.back();
+	        interface.getArguments() = arguments;
+	        interface.initializeModel();
+	        ProfileVector flatPrior;
+	        if (!Rf_isNull(exclude[i])) {
+	            flatPrior = as<ProfileVector>(exclude[i]);
+	        }
+	        interface.setPrior(priorTypeName, variance, flatPrior,
+                               HierarchicalChildMap(), NeighborhoodMap());
+	        interface.getCcd().getProgressLogger().setConcurrent(true);
+	        interface.getCcd().getErrorHandler().setConcurrent(true);
+	    }
+
+	    auto fitOne = [&wave, &fits, &arguments, waveStart, computeSEs](int i) {
+	        auto& ccd = wave[i - waveStart]->getCcd();
+	        auto& data = wave[i - waveStart]->getModelData();
+	        auto& fit = fits[i];
+
+	        ccd.update(arguments.modeFinding);
+	        getEstimates(ccd, data, fit.labels, fit.estimates);
+	        fit.logLikelihood = ccd.getLogLikelihood();
+	        fit.iterations = ccd.getIterationCount();
+
+	        fit.standardErrors.assign(fit.estimates.size(), NA_REAL);
+	        if (computeSEs && ccd.getUpdateReturnFlag() == SUCCESS && data.getCollapsedIndex().empty()) {
+	            std::vector<size_t> indices;
+	            for (int index = data.getHasOffsetCovariate() ? 1 : 0; index < ccd.getBetaSize(); ++index) {
+	                indices.push_back(index);
+	            }
+	            const CyclicCoordinateDescent::Matrix covariance =
+                    ccd.computeFisherInformation(indices).inverse();
+	            for (size_t k = 0; k < indices.size(); ++k) {
+	                fit.standardErrors[k] = std::sqrt(covariance(k, k));
+	            }
+	        }
+	    };
+
+	    if (nThreads == 1) {
+	        for (int i = waveStart; i < waveEnd; ++i) {
+	            fitOne(i);
+	        }
+	    } else {
+	        TaskScheduler<boost::counting_iterator<int> > scheduler(
+                boost::make_counting_iterator(waveStart),
+                boost::make_counting_iterator(waveEnd),
+                nThreads, templateInterface->getCcd().getWorkerPool());
+	        scheduler.execute(fitOne);
+	    }
+
+	    for (int i = waveStart; i < waveEnd; ++i) {
+	        auto& ccd = wave[i - waveStart]->getCcd();
+	        fits[i].returnFlag = DiagnosticsOutputWriter(ccd, wave[i - waveStart]->getModelData())
+                .returnFlagString(ccd.getUpdateReturnFlag());
+	        ccd.getProgressLogger().setConcurrent(false);
+	        ccd.getErrorHandler().setConcurrent(false);
+	        ccd.getProgressLogger().flush();
+	        ccd.getErrorHandler().flush();
+	    }
+	}
+
+	// Long format: one row per model and covariate
+	std::vector<int> model, summaryModel(nModels), iterations(nModels);
+	std::vector<double> labels, estimates, standardErrors, logLikelihood(nModels);
+	std::vector<std::string> returnFlag(nModels);
+	for (int i = 0; i < nModels; ++i) {
+	    const auto& fit = fits[i];
+	    model.insert(model.end(), fit.labels.size(), i + 1);
+	    labels.insert(labels.end(), fit.labels.begin(), fit.labels.end());
+	    estimates.insert(estimates.end(), fit.estimates.begin(), fit.estimates.end());
+	    standardErrors.insert(standardErrors.end(), fit.standardErrors.begin(), fit.standardErrors.end());
+	    summaryModel[i] = i + 1;
+	    logLikelihood[i] = fit.logLikelihood;
+	    iterations[i] = fit.iterations;
+	    returnFlag[i] = fit.returnFlag;
+	}
+
+	return List::create(
+	    Named("estimates") = DataFrame::create(
+	        Named("model") = model,
+	        Named("column_label") = labels,
+	        Named("estimate") = estimates,
+	        Named("se") = standardErrors,
+	        Named("stringsAsFactors") = false),
+	    Named("models") = DataFrame::create(
+	        Named("model") = summaryModel,
+	        Named("log_likelihood") = logLikelihood,
+	        Named("iterations") = iterations,
+	        Named("return_flag") = returnFlag,
+	        Named("stringsAsFactors") = false)
+	);
+}
+
 // [[Rcpp::export(".cyclopsLogModel")]]
 List cyclopsLogModel(SEXP inRcppCcdInterface) {
 	using namespace bsccs;
@@ -505,11 +926,7 @@ List cyclopsLogModel(SEXP inRcppCcdInterface) {
 
 	std::vector<double> labels;
 	std::vector<double> values;
-    auto index = data.getHasOffsetCovariate() ? 1 : 0;
-    for ( ; index < ccd.getBetaSize(); ++index) {
-        labels.push_back(data.getColumnNumericalLabel(index));
-        values.push_back(ccd.getBeta(index));
-    }
+	getEstimates(ccd, data, labels, values);
 
 	auto end = bsccs::chrono::steady_clock::now();
 	bsccs::chrono::duration<double> elapsed_seconds = end-start;
@@ -740,7 +1157,40 @@ priors::JointPriorPtr RcppCcdInterface::makePrior(const std::vector<std::string>
         prior->changePrior(columnPrior, i);
     }
 
-    return prior;
+    return collapsePrior(prior);
+}
+
+// Columns standing in for several identical covariates get a prior on the sum of their coefficients
+priors::JointPriorPtr RcppCcdInterface::collapsePrior(bsccs::shared_ptr<priors::MixtureJointPrior> prior) {
+	using namespace bsccs::priors;
+
+	const auto& multiplicity = modelData->getColumnMultiplicity();
+	std::map<std::pair<CovariatePrior*, int>, PriorPtr> collapsed; // Share wrappers across columns
+
+	for (size_t index = 0; index < multiplicity.size(); ++index) {
+		if (multiplicity[index] > 1) {
+			PriorPtr base = prior->getPrior(index);
+			auto& wrapped = collapsed[std::make_pair(base.get(), multiplicity[index])];
+			if (!wrapped) {
+				wrapped = bsccs::make_shared<CollapsedPrior>(base, multiplicity[index]);
+			}
+			prior->changePrior(wrapped, index);
+		}
+	}
+	return prior;
+}
+
+// Covariates removed as duplicates at finalization resolve to the column that represents them
+int RcppCcdInterface::getColumnIndexForCovariate(IdType covariate) const {
+	int index = modelData->getColumnIndexByName(covariate);
+	if (index == -1) {
+		const auto& labels = modelData->getCollapsedLabels();
+		const auto it = std::find(labels.begin(), labels.end(), covariate);
+		if (it != labels.end()) {
+			index = modelData->getCollapsedIndex()[std::distance(labels.begin(), it)];
+		}
+	}
+	return index;
 }
 
 void RcppCcdInterface::setPrior(const std::vector<std::string>& basePriorName, const std::vector<double>& baseVariance,
@@ -773,9 +1223,11 @@ priors::JointPriorPtr RcppCcdInterface::makePrior(const std::vector<std::string>
 
 //         std::cerr << "Constructed variable prior per column" << std::endl;
 
-        return prior;
+        return collapsePrior(prior);
     }
 
+    const bool isCollapsed = !modelData->getColumnMultiplicity().empty();
+
     PriorPtr singlePrior = bsccs::priors::CovariatePrior::makePrior(parsePriorType(basePriorName[0]), baseVariance[0]);
     // singlePrior->setVariance(0, baseVariance[0]);
 
@@ -783,8 +1235,16 @@ priors::JointPriorPtr RcppCcdInterface::makePrior(const std::vector<std::string>
 
  	if (flatPrior.size() == 0 && neighborhood.size() == 0) {
  		if (hierarchyMap.size() == 0) {
-	 		prior = bsccs::make_shared<FullyExchangeableJointPrior>(singlePrior);
+ 			if (isCollapsed) {
+ 				prior = collapsePrior(bsccs::make_shared<MixtureJointPrior>(
+ 					singlePrior, modelData->getNumberOfCovariates()));
+ 			} else {
+	 			prior = bsccs::make_shared<FullyExchangeableJointPrior>(singlePrior);
+ 			}
 	 	} else {
+	 		if (isCollapsed) {
+	 			handleError("Hierarchical priors are not supported with collapsed duplicate columns.");
+	 		}
 			bsccs::shared_ptr<HierarchicalJointPrior> hPrior =
                 bsccs::make_shared<HierarchicalJointPrior>(singlePrior, 2); //Depth of hierarchy fixed at 2 right now
                 // TODO Check normal at top of hierarchy!
@@ -816,7 +1276,7 @@ priors::JointPriorPtr RcppCcdInterface::makePrior(const std::vector<std::string>
 			PriorPtr noPrior = bsccs::make_shared<NoPrior>();
 			for (ProfileVector::const_iterator it = flatPrior.begin();
 					it != flatPrior.end(); ++it) {
-				int index = modelData->getColumnIndexByName(*it);
+				int index = getColumnIndexForCovariate(*it);
 				if (index == -1) {
 					std::stringstream error;
 					error << "Variable " << *it << " not found.";
@@ -828,6 +1288,9 @@ priors::JointPriorPtr RcppCcdInterface::makePrior(const std::vector<std::string>
 		}
 
  		if (neighborhood.size() > 0) {
+			if (isCollapsed) {
+				handleError("Fused priors are not supported with collapsed duplicate columns.");
+			}
 
 			// shared across all index covariates
  			// PriorPtr classPrior = bsccs::priors::CovariatePrior::makePrior(parsePriorType(basePriorName[1]), baseVariance[1]);
@@ -863,7 +1326,7 @@ priors::JointPriorPtr RcppCcdInterface::makePrior(const std::vector<std::string>
  			}
  		}
 
- 		prior = mixturePrior;
+ 		prior = collapsePrior(mixturePrior);
  		if (hierarchyMap.size() != 0) {
  			handleError("Mixtures of flat and hierarchical priors are not yet implemented.");
  		}
@@ -974,7 +1437,19 @@ void RcppCcdInterface::predictModelImpl(CyclicCoordinateDescent *ccd, AbstractMo
     //std::vector<double> predictions(ccd->getPredictionSize());
     ccd->getPredictiveEstimates(&predictions[0], NULL);
 
-    if (modelData->getHasRowLabels()) {
+    const auto& rowIndex = modelData->getCompressedRowIndex();
+    if (!rowIndex.empty()) { // Expand compressed rows back to the original rows
+        const auto& share = modelData->getCompressedRowShare(); // Summed Poisson rows
+        NumericVector expanded(rowIndex.size());
+        for (size_t i = 0; i < rowIndex.size(); ++i) {
+            expanded[i] = predictions[rowIndex[i]] * (share.empty() ? 1.0 : share[i]);
+        }
+        const auto& rowLabels = modelData->getUncompressedRowLabels();
+        if (rowLabels.size() == rowIndex.size()) {
+            expanded.names() = CharacterVector(rowLabels.begin(), rowLabels.end());
+        }
+        predictions = expanded;
+    } else if (modelData->getHasRowLabels()) {
         size_t preds = ccd->getPredictionSize();
         CharacterVector labels(preds);
         for (size_t i = 0; i < preds; ++i) {
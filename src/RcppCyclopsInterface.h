@@ -59,6 +59,17 @@ public:
         return CcdInterface::evaluateProfileModel(ccd, modelData, covariate, points, values, threads, includePenalty);
     }
 
+    double evaluateProfileModel(const IdType covariate,
+                                double lowerBound, double upperBound,
+                                int initialGridSize, double tolerance, double threshold,
+                                std::vector<double>& points,
+                                std::vector<double>& values,
+                                int threads, bool includePenalty) {
+        return CcdInterface::evaluateProfileModel(ccd, modelData, covariate, lowerBound, upperBound,
+                                                  initialGridSize, tolerance, threshold,
+                                                  points, values, threads, includePenalty);
+    }
+
     double runCrossValidation() {
     	return CcdInterface::runCrossValidation(ccd, modelData);
     }
@@ -125,6 +136,10 @@ protected:
 				const HierarchicalChildMap& map,
 				const NeighborhoodMap& neighborhood);
 
+    priors::JointPriorPtr collapsePrior(bsccs::shared_ptr<priors::MixtureJointPrior> prior);
+
+    int getColumnIndexForCovariate(IdType covariate) const;
+
     void initializeModelImpl(
             AbstractModelData** modelData,
             CyclicCoordinateDescent** ccd,
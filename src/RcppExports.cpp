@@ -219,6 +219,24 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cyclopsGetAdaptiveProfileLikelihood
+DataFrame cyclopsGetAdaptiveProfileLikelihood(SEXP inRcppCcdInterface, SEXP inCovariate, const std::vector<double> bounds, int initialGridSize, double tolerance, double threshold, int threads, bool includePenalty);
+RcppExport SEXP _Cyclops_cyclopsGetAdaptiveProfileLikelihood(SEXP inRcppCcdInterfaceSEXP, SEXP inCovariateSEXP, SEXP boundsSEXP, SEXP initialGridSizeSEXP, SEXP toleranceSEXP, SEXP thresholdSEXP, SEXP threadsSEXP, SEXP includePenaltySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type inCovariate(inCovariateSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double> >::type bounds(boundsSEXP);
+    Rcpp::traits::input_parameter< int >::type initialGridSize(initialGridSizeSEXP);
+    Rcpp::traits::input_parameter< double >::type tolerance(toleranceSEXP);
+    Rcpp::traits::input_parameter< double >::type threshold(thresholdSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type includePenalty(includePenaltySEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetAdaptiveProfileLikelihood(inRcppCcdInterface, inCovariate, bounds, initialGridSize, tolerance, threshold, threads, includePenalty));
+    return rcpp_result_gen;
+END_RCPP
+}
 // cyclopsProfileModel
 List cyclopsProfileModel(SEXP inRcppCcdInterface, SEXP sexpCovariates, int threads, double threshold, bool override, bool includePenalty);
 RcppExport SEXP _Cyclops_cyclopsProfileModel(SEXP inRcppCcdInterfaceSEXP, SEXP sexpCovariatesSEXP, SEXP threadsSEXP, SEXP thresholdSEXP, SEXP overrideSEXP, SEXP includePenaltySEXP) {
@@ -247,8 +265,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // cyclopsSetControl
-void cyclopsSetControl(SEXP inRcppCcdInterface, int maxIterations, double tolerance, const std::string& convergenceType, bool useAutoSearch, int fold, int foldToCompute, double lowerLimit, double upperLimit, int gridSteps, const std::string& noiseLevel, int threads, int seed, bool resetCoefficients, double startingVariance, bool useKKTSwindle, int swindleMultipler, const std::string& selectorType, double initialBound, int maxBoundCount, const std::string& algorithm);
-RcppExport SEXP _Cyclops_cyclopsSetControl(SEXP inRcppCcdInterfaceSEXP, SEXP maxIterationsSEXP, SEXP toleranceSEXP, SEXP convergenceTypeSEXP, SEXP useAutoSearchSEXP, SEXP foldSEXP, SEXP foldToComputeSEXP, SEXP lowerLimitSEXP, SEXP upperLimitSEXP, SEXP gridStepsSEXP, SEXP noiseLevelSEXP, SEXP threadsSEXP, SEXP seedSEXP, SEXP resetCoefficientsSEXP, SEXP startingVarianceSEXP, SEXP useKKTSwindleSEXP, SEXP swindleMultiplerSEXP, SEXP selectorTypeSEXP, SEXP initialBoundSEXP, SEXP maxBoundCountSEXP, SEXP algorithmSEXP) {
+void cyclopsSetControl(SEXP inRcppCcdInterface, int maxIterations, double tolerance, const std::string& convergenceType, bool useAutoSearch, int fold, int foldToCompute, double lowerLimit, double upperLimit, int gridSteps, const std::string& noiseLevel, int threads, int seed, bool resetCoefficients, double startingVariance, bool useKKTSwindle, int swindleMultipler, const std::string& selectorType, double initialBound, int maxBoundCount, const std::string& algorithm, bool useBatchSearch, bool useProfiler, int convergenceTrace, bool threadAffinity, int newtonMaxCovariates, int stationaryCycles, const std::string& checkpointFile, int checkpointInterval);
+RcppExport SEXP _Cyclops_cyclopsSetControl(SEXP inRcppCcdInterfaceSEXP, SEXP maxIterationsSEXP, SEXP toleranceSEXP, SEXP convergenceTypeSEXP, SEXP useAutoSearchSEXP, SEXP foldSEXP, SEXP foldToComputeSEXP, SEXP lowerLimitSEXP, SEXP upperLimitSEXP, SEXP gridStepsSEXP, SEXP noiseLevelSEXP, SEXP threadsSEXP, SEXP seedSEXP, SEXP resetCoefficientsSEXP, SEXP startingVarianceSEXP, SEXP useKKTSwindleSEXP, SEXP swindleMultiplerSEXP, SEXP selectorTypeSEXP, SEXP initialBoundSEXP, SEXP maxBoundCountSEXP, SEXP algorithmSEXP, SEXP useBatchSearchSEXP, SEXP useProfilerSEXP, SEXP convergenceTraceSEXP, SEXP threadAffinitySEXP, SEXP newtonMaxCovariatesSEXP, SEXP stationaryCyclesSEXP, SEXP checkpointFileSEXP, SEXP checkpointIntervalSEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
@@ -272,7 +290,15 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< double >::type initialBound(initialBoundSEXP);
     Rcpp::traits::input_parameter< int >::type maxBoundCount(maxBoundCountSEXP);
     Rcpp::traits::input_parameter< const std::string& >::type algorithm(algorithmSEXP);
-    cyclopsSetControl(inRcppCcdInterface, maxIterations, tolerance, convergenceType, useAutoSearch, fold, foldToCompute, lowerLimit, upperLimit, gridSteps, noiseLevel, threads, seed, resetCoefficients, startingVariance, useKKTSwindle, swindleMultipler, selectorType, initialBound, maxBoundCount, algorithm);
+    Rcpp::traits::input_parameter< bool >::type useBatchSearch(useBatchSearchSEXP);
+    Rcpp::traits::input_parameter< bool >::type useProfiler(useProfilerSEXP);
+    Rcpp::traits::input_parameter< int >::type convergenceTrace(convergenceTraceSEXP);
+    Rcpp::traits::input_parameter< bool >::type threadAffinity(threadAffinitySEXP);
+    Rcpp::traits::input_parameter< int >::type newtonMaxCovariates(newtonMaxCovariatesSEXP);
+    Rcpp::traits::input_parameter< int >::type stationaryCycles(stationaryCyclesSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type checkpointFile(checkpointFileSEXP);
+    Rcpp::traits::input_parameter< int >::type checkpointInterval(checkpointIntervalSEXP);
+    cyclopsSetControl(inRcppCcdInterface, maxIterations, tolerance, convergenceType, useAutoSearch, fold, foldToCompute, lowerLimit, upperLimit, gridSteps, noiseLevel, threads, seed, resetCoefficients, startingVariance, useKKTSwindle, swindleMultipler, selectorType, initialBound, maxBoundCount, algorithm, useBatchSearch, useProfiler, convergenceTrace, threadAffinity, newtonMaxCovariates, stationaryCycles, checkpointFile, checkpointInterval);
     return R_NilValue;
 END_RCPP
 }
@@ -637,8 +663,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // cyclopsFinalizeData
-void cyclopsFinalizeData(Environment x, bool addIntercept, SEXP sexpOffsetCovariate, bool offsetAlreadyOnLogScale, bool sortCovariates, SEXP sexpCovariatesDense, bool magicFlag);
-RcppExport SEXP _Cyclops_cyclopsFinalizeData(SEXP xSEXP, SEXP addInterceptSEXP, SEXP sexpOffsetCovariateSEXP, SEXP offsetAlreadyOnLogScaleSEXP, SEXP sortCovariatesSEXP, SEXP sexpCovariatesDenseSEXP, SEXP magicFlagSEXP) {
+void cyclopsFinalizeData(Environment x, bool addIntercept, SEXP sexpOffsetCovariate, bool offsetAlreadyOnLogScale, bool sortCovariates, SEXP sexpCovariatesDense, bool magicFlag, bool collapseDuplicates, bool compressRows, std::string outOfCoreFile, double outOfCoreCacheSize);
+RcppExport SEXP _Cyclops_cyclopsFinalizeData(SEXP xSEXP, SEXP addInterceptSEXP, SEXP sexpOffsetCovariateSEXP, SEXP offsetAlreadyOnLogScaleSEXP, SEXP sortCovariatesSEXP, SEXP sexpCovariatesDenseSEXP, SEXP magicFlagSEXP, SEXP collapseDuplicatesSEXP, SEXP compressRowsSEXP, SEXP outOfCoreFileSEXP, SEXP outOfCoreCacheSizeSEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
@@ -648,7 +674,11 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< bool >::type sortCovariates(sortCovariatesSEXP);
     Rcpp::traits::input_parameter< SEXP >::type sexpCovariatesDense(sexpCovariatesDenseSEXP);
     Rcpp::traits::input_parameter< bool >::type magicFlag(magicFlagSEXP);
-    cyclopsFinalizeData(x, addIntercept, sexpOffsetCovariate, offsetAlreadyOnLogScale, sortCovariates, sexpCovariatesDense, magicFlag);
+    Rcpp::traits::input_parameter< bool >::type collapseDuplicates(collapseDuplicatesSEXP);
+    Rcpp::traits::input_parameter< bool >::type compressRows(compressRowsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type outOfCoreFile(outOfCoreFileSEXP);
+    Rcpp::traits::input_parameter< double >::type outOfCoreCacheSize(outOfCoreCacheSizeSEXP);
+    cyclopsFinalizeData(x, addIntercept, sexpOffsetCovariate, offsetAlreadyOnLogScale, sortCovariates, sexpCovariatesDense, magicFlag, collapseDuplicates, compressRows, outOfCoreFile, outOfCoreCacheSize);
     return R_NilValue;
 END_RCPP
 }
@@ -763,6 +793,200 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cyclopsNewDataScorer
+SEXP cyclopsNewDataScorer(const std::vector<double>& rowId, const std::vector<double>& covariateId, const std::vector<double>& beta, double intercept);
+RcppExport SEXP _Cyclops_cyclopsNewDataScorer(SEXP rowIdSEXP, SEXP covariateIdSEXP, SEXP betaSEXP, SEXP interceptSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type rowId(rowIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type covariateId(covariateIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type beta(betaSEXP);
+    Rcpp::traits::input_parameter< double >::type intercept(interceptSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsNewDataScorer(rowId, covariateId, beta, intercept));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsScoreNewData
+void cyclopsScoreNewData(SEXP inScorer, const std::vector<double>& rowId, const std::vector<double>& covariateId, const std::vector<double>& covariateValue);
+RcppExport SEXP _Cyclops_cyclopsScoreNewData(SEXP inScorerSEXP, SEXP rowIdSEXP, SEXP covariateIdSEXP, SEXP covariateValueSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inScorer(inScorerSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type rowId(rowIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type covariateId(covariateIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type covariateValue(covariateValueSEXP);
+    cyclopsScoreNewData(inScorer, rowId, covariateId, covariateValue);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsGetNewDataPredictions
+NumericVector cyclopsGetNewDataPredictions(SEXP inScorer, const std::string& modelType, const std::vector<double>& time, const std::vector<double>& stratumId, const std::vector<double>& baselineTime, const std::vector<double>& baselineCumulativeHazard);
+RcppExport SEXP _Cyclops_cyclopsGetNewDataPredictions(SEXP inScorerSEXP, SEXP modelTypeSEXP, SEXP timeSEXP, SEXP stratumIdSEXP, SEXP baselineTimeSEXP, SEXP baselineCumulativeHazardSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inScorer(inScorerSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type modelType(modelTypeSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type time(timeSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type stratumId(stratumIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type baselineTime(baselineTimeSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type baselineCumulativeHazard(baselineCumulativeHazardSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetNewDataPredictions(inScorer, modelType, time, stratumId, baselineTime, baselineCumulativeHazard));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsGetBaselineHazard
+List cyclopsGetBaselineHazard(SEXP inRcppCcdInterface);
+RcppExport SEXP _Cyclops_cyclopsGetBaselineHazard(SEXP inRcppCcdInterfaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetBaselineHazard(inRcppCcdInterface));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsSetFineGrayCensorWeights
+void cyclopsSetFineGrayCensorWeights(SEXP inRcppCcdInterface);
+RcppExport SEXP _Cyclops_cyclopsSetFineGrayCensorWeights(SEXP inRcppCcdInterfaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    cyclopsSetFineGrayCensorWeights(inRcppCcdInterface);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsGetProfile
+DataFrame cyclopsGetProfile(SEXP inRcppCcdInterface);
+RcppExport SEXP _Cyclops_cyclopsGetProfile(SEXP inRcppCcdInterfaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetProfile(inRcppCcdInterface));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsGetSolverState
+Rcpp::RawVector cyclopsGetSolverState(SEXP inRcppCcdInterface);
+RcppExport SEXP _Cyclops_cyclopsGetSolverState(SEXP inRcppCcdInterfaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetSolverState(inRcppCcdInterface));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsSetSolverState
+void cyclopsSetSolverState(SEXP inRcppCcdInterface, Rcpp::RawVector state);
+RcppExport SEXP _Cyclops_cyclopsSetSolverState(SEXP inRcppCcdInterfaceSEXP, SEXP stateSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    Rcpp::traits::input_parameter< Rcpp::RawVector >::type state(stateSEXP);
+    cyclopsSetSolverState(inRcppCcdInterface, state);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsUpdateForAppendedData
+bool cyclopsUpdateForAppendedData(SEXP inRcppCcdInterface);
+RcppExport SEXP _Cyclops_cyclopsUpdateForAppendedData(SEXP inRcppCcdInterfaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsUpdateForAppendedData(inRcppCcdInterface));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsGetConvergenceTrace
+DataFrame cyclopsGetConvergenceTrace(SEXP inRcppCcdInterface);
+RcppExport SEXP _Cyclops_cyclopsGetConvergenceTrace(SEXP inRcppCcdInterfaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetConvergenceTrace(inRcppCcdInterface));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsGetCollapsedCovariates
+DataFrame cyclopsGetCollapsedCovariates(Environment x);
+RcppExport SEXP _Cyclops_cyclopsGetCollapsedCovariates(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetCollapsedCovariates(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsAddInteractions
+void cyclopsAddInteractions(Environment x, const std::vector<double>& covariateId, const std::vector<double>& firstCovariateId, const std::vector<double>& secondCovariateId);
+RcppExport SEXP _Cyclops_cyclopsAddInteractions(SEXP xSEXP, SEXP covariateIdSEXP, SEXP firstCovariateIdSEXP, SEXP secondCovariateIdSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type covariateId(covariateIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type firstCovariateId(firstCovariateIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type secondCovariateId(secondCovariateIdSEXP);
+    cyclopsAddInteractions(x, covariateId, firstCovariateId, secondCovariateId);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsFitOutcomes
+List cyclopsFitOutcomes(SEXP inRcppCcdInterface, const NumericMatrix& outcomes);
+RcppExport SEXP _Cyclops_cyclopsFitOutcomes(SEXP inRcppCcdInterfaceSEXP, SEXP outcomesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    Rcpp::traits::input_parameter< const NumericMatrix& >::type outcomes(outcomesSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsFitOutcomes(inRcppCcdInterface, outcomes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsFitModels
+List cyclopsFitModels(SEXP inRcppCcdInterface, const List& modelData, const std::vector<std::string>& priorTypeName, const std::vector<double>& variance, const List& exclude, bool computeSEs);
+RcppExport SEXP _Cyclops_cyclopsFitModels(SEXP inRcppCcdInterfaceSEXP, SEXP modelDataSEXP, SEXP priorTypeNameSEXP, SEXP varianceSEXP, SEXP excludeSEXP, SEXP computeSEsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    Rcpp::traits::input_parameter< const List& >::type modelData(modelDataSEXP);
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type priorTypeName(priorTypeNameSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type variance(varianceSEXP);
+    Rcpp::traits::input_parameter< const List& >::type exclude(excludeSEXP);
+    Rcpp::traits::input_parameter< bool >::type computeSEs(computeSEsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsFitModels(inRcppCcdInterface, modelData, priorTypeName, variance, exclude, computeSEs));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsGetLogLikelihoodGradient
+List cyclopsGetLogLikelihoodGradient(SEXP inRcppCcdInterface);
+RcppExport SEXP _Cyclops_cyclopsGetLogLikelihoodGradient(SEXP inRcppCcdInterfaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetLogLikelihoodGradient(inRcppCcdInterface));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsGetHessianVectorProduct
+std::vector<double> cyclopsGetHessianVectorProduct(SEXP inRcppCcdInterface, std::vector<double> vector);
+RcppExport SEXP _Cyclops_cyclopsGetHessianVectorProduct(SEXP inRcppCcdInterfaceSEXP, SEXP vectorSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type vector(vectorSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetHessianVectorProduct(inRcppCcdInterface, vector));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
     {"_Cyclops_cyclopsGetModelTypeNames", (DL_FUNC) &_Cyclops_cyclopsGetModelTypeNames, 0},
@@ -783,9 +1007,10 @@ static const R_CallMethodDef CallEntries[] = {
     {"_Cyclops_cyclopsTestParameterizedPrior", (DL_FUNC) &_Cyclops_cyclopsTestParameterizedPrior, 4},
     {"_Cyclops_cyclopsSetParameterizedPrior", (DL_FUNC) &_Cyclops_cyclopsSetParameterizedPrior, 5},
     {"_Cyclops_cyclopsGetProfileLikelihood", (DL_FUNC) &_Cyclops_cyclopsGetProfileLikelihood, 5},
+    {"_Cyclops_cyclopsGetAdaptiveProfileLikelihood", (DL_FUNC) &_Cyclops_cyclopsGetAdaptiveProfileLikelihood, 8},
     {"_Cyclops_cyclopsProfileModel", (DL_FUNC) &_Cyclops_cyclopsProfileModel, 6},
     {"_Cyclops_cyclopsPredictModel", (DL_FUNC) &_Cyclops_cyclopsPredictModel, 1},
-    {"_Cyclops_cyclopsSetControl", (DL_FUNC) &_Cyclops_cyclopsSetControl, 21},
+    {"_Cyclops_cyclopsSetControl", (DL_FUNC) &_Cyclops_cyclopsSetControl, 29},
     {"_Cyclops_cyclopsRunCrossValidationl", (DL_FUNC) &_Cyclops_cyclopsRunCrossValidationl, 1},
     {"_Cyclops_cyclopsFitModel", (DL_FUNC) &_Cyclops_cyclopsFitModel, 1},
     {"_Cyclops_cyclopsLogModel", (DL_FUNC) &_Cyclops_cyclopsLogModel, 1},
@@ -817,7 +1042,7 @@ static const R_CallMethodDef CallEntries[] = {
     {"_Cyclops_cyclopsGetMeanOffset", (DL_FUNC) &_Cyclops_cyclopsGetMeanOffset, 1},
     {"_Cyclops_cyclopsGetYVector", (DL_FUNC) &_Cyclops_cyclopsGetYVector, 1},
     {"_Cyclops_cyclopsGetTimeVector", (DL_FUNC) &_Cyclops_cyclopsGetTimeVector, 1},
-    {"_Cyclops_cyclopsFinalizeData", (DL_FUNC) &_Cyclops_cyclopsFinalizeData, 7},
+    {"_Cyclops_cyclopsFinalizeData", (DL_FUNC) &_Cyclops_cyclopsFinalizeData, 11},
     {"_Cyclops_cyclopsLoadDataY", (DL_FUNC) &_Cyclops_cyclopsLoadDataY, 5},
     {"_Cyclops_cyclopsLoadDataMultipleX", (DL_FUNC) &_Cyclops_cyclopsLoadDataMultipleX, 8},
     {"_Cyclops_cyclopsLoadDataX", (DL_FUNC) &_Cyclops_cyclopsLoadDataX, 7},
@@ -825,6 +1050,22 @@ static const R_CallMethodDef CallEntries[] = {
     {"_Cyclops_cyclopsGetInterceptLabel", (DL_FUNC) &_Cyclops_cyclopsGetInterceptLabel, 1},
     {"_Cyclops_cyclopsReadFileData", (DL_FUNC) &_Cyclops_cyclopsReadFileData, 2},
     {"_Cyclops_cyclopsModelData", (DL_FUNC) &_Cyclops_cyclopsModelData, 11},
+    {"_Cyclops_cyclopsNewDataScorer", (DL_FUNC) &_Cyclops_cyclopsNewDataScorer, 4},
+    {"_Cyclops_cyclopsScoreNewData", (DL_FUNC) &_Cyclops_cyclopsScoreNewData, 4},
+    {"_Cyclops_cyclopsGetNewDataPredictions", (DL_FUNC) &_Cyclops_cyclopsGetNewDataPredictions, 6},
+    {"_Cyclops_cyclopsGetBaselineHazard", (DL_FUNC) &_Cyclops_cyclopsGetBaselineHazard, 1},
+    {"_Cyclops_cyclopsSetFineGrayCensorWeights", (DL_FUNC) &_Cyclops_cyclopsSetFineGrayCensorWeights, 1},
+    {"_Cyclops_cyclopsGetProfile", (DL_FUNC) &_Cyclops_cyclopsGetProfile, 1},
+    {"_Cyclops_cyclopsGetSolverState", (DL_FUNC) &_Cyclops_cyclopsGetSolverState, 1},
+    {"_Cyclops_cyclopsSetSolverState", (DL_FUNC) &_Cyclops_cyclopsSetSolverState, 2},
+    {"_Cyclops_cyclopsUpdateForAppendedData", (DL_FUNC) &_Cyclops_cyclopsUpdateForAppendedData, 1},
+    {"_Cyclops_cyclopsGetConvergenceTrace", (DL_FUNC) &_Cyclops_cyclopsGetConvergenceTrace, 1},
+    {"_Cyclops_cyclopsGetCollapsedCovariates", (DL_FUNC) &_Cyclops_cyclopsGetCollapsedCovariates, 1},
+    {"_Cyclops_cyclopsAddInteractions", (DL_FUNC) &_Cyclops_cyclopsAddInteractions, 4},
+    {"_Cyclops_cyclopsFitOutcomes", (DL_FUNC) &_Cyclops_cyclopsFitOutcomes, 2},
+    {"_Cyclops_cyclopsFitModels", (DL_FUNC) &_Cyclops_cyclopsFitModels, 6},
+    {"_Cyclops_cyclopsGetLogLikelihoodGradient", (DL_FUNC) &_Cyclops_cyclopsGetLogLikelihoodGradient, 1},
+    {"_Cyclops_cyclopsGetHessianVectorProduct", (DL_FUNC) &_Cyclops_cyclopsGetHessianVectorProduct, 2},
     {NULL, NULL, 0}
 };
 
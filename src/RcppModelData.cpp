@@ -469,7 +469,11 @@ void cyclopsFinalizeData(
         bool offsetAlreadyOnLogScale,
         bool sortCovariates,
         SEXP sexpCovariatesDense,
-        bool magicFlag = false) {
+        bool magicFlag = false,
+        bool collapseDuplicates = false,
+        bool compressRows = false,
+        std::string outOfCoreFile = "",
+        double outOfCoreCacheSize = 0) {
     using namespace bsccs;
     XPtr<AbstractModelData> data = parseEnvironmentForPtr(x);
 
@@ -542,9 +546,75 @@ void cyclopsFinalizeData(
         }
     }
 
+    if (compressRows) {
+        data->compressRows();
+    }
+
+    if (collapseDuplicates) {
+        data->collapseDuplicateColumns();
+    }
+
+    if (!outOfCoreFile.empty()) {
+        if (outOfCoreCacheSize < 0) {
+            stop("Out-of-core cache size must be non-negative");
+        }
+        data->spillColumnsToFile(outOfCoreFile, static_cast<size_t>(outOfCoreCacheSize));
+    }
+
     data->setIsFinalized(true);
 }
 
+// [[Rcpp::export(".cyclopsGetCollapsedCovariates")]]
+DataFrame cyclopsGetCollapsedCovariates(Environment x) {
+    using namespace bsccs;
+    XPtr<AbstractModelData> data = parseEnvironmentForPtr(x);
+
+    const auto& labels = data->getCollapsedLabels();
+    const auto& index = data->getCollapsedIndex();
+
+    NumericVector covariateId;
+    NumericVector representativeId;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        const int64_t representative = data->getColumnNumericalLabel(index[i]);
+        if (labels[i] != representative) {
+            const int64_t label = labels[i];
+            double bit;
+            std::memcpy(&bit, &label, sizeof(double));
+            covariateId.push_back(bit);
+            std::memcpy(&bit, &representative, sizeof(double));
+            representativeId.push_back(bit);
+        }
+    }
+    covariateId.attr("class") = "integer64";
+    representativeId.attr("class") = "integer64";
+
+    return DataFrame::create(
+        Rcpp::Named("covariateId") = covariateId,
+        Rcpp::Named("representativeId") = representativeId
+    );
+}
+
+// [[Rcpp::export(".cyclopsAddInteractions")]]
+void cyclopsAddInteractions(Environment x,
+                            const std::vector<double>& covariateId,
+                            const std::vector<double>& firstCovariateId,
+                            const std::vector<double>& secondCovariateId) {
+    using namespace bsccs;
+    XPtr<AbstractModelData> data = parseEnvironmentForPtr(x);
+
+    if (data->getIsFinalized()) {
+        ::Rf_error("OHDSI data object is already finalized");
+    }
+
+    const auto& covariate = reinterpret_cast<const std::vector<int64_t>&>(covariateId);
+    const auto& first = reinterpret_cast<const std::vector<int64_t>&>(firstCovariateId);
+    const auto& second = reinterpret_cast<const std::vector<int64_t>&>(secondCovariateId);
+
+    for (size_t i = 0; i < covariate.size(); ++i) {
+        data->addInteraction(covariate[i], first[i], second[i]);
+    }
+}
+
 // [[Rcpp::export(".loadCyclopsDataY")]]
 void cyclopsLoadDataY(Environment x,
                       const std::vector<double>& stratumId,
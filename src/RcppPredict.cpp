@@ -0,0 +1,212 @@
+/**
+ * @file RcppPredict.cpp
+ *
+ * This file is part of Cyclops
+ *
+ * Copyright 2020 Observational Health Data Sciences and Informatics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Rcpp.h"
+
+using namespace Rcpp;
+
+namespace bsccs {
+
+// Maps 64-bit identifiers to positions; uses a dense table when identifiers are compact
+class IdIndex {
+public:
+    IdIndex() : minId(0) { }
+
+    explicit IdIndex(const std::vector<int64_t>& ids) : minId(0) {
+        if (ids.empty()) return;
+
+        const auto range = std::minmax_element(std::begin(ids), std::end(ids));
+        minId = *range.first;
+        const uint64_t span = static_cast<uint64_t>(*range.second - *range.first) + 1;
+
+        if (span <= 4 * ids.size() + 1024) {
+            dense.assign(span, -1);
+            for (size_t i = 0; i < ids.size(); ++i) {
+                dense[ids[i] - minId] = i;
+            }
+        } else {
+            sparse.reserve(ids.size());
+            for (size_t i = 0; i < ids.size(); ++i) {
+                sparse.emplace(ids[i], i);
+            }
+        }
+    }
+
+    long find(int64_t id) const {
+        if (!dense.empty()) {
+            if (id < minId) return -1;
+            const uint64_t offset = static_cast<uint64_t>(id - minId);
+            return (offset < dense.size()) ? dense[offset] : -1;
+        }
+        const auto it = sparse.find(id);
+        return (it != sparse.end()) ? static_cast<long>(it->second) : -1;
+    }
+
+private:
+    int64_t minId;
+    std::vector<long> dense;
+    std::unordered_map<int64_t, size_t> sparse;
+};
+
+// Accumulates X * beta for new data one covariate batch at a time; outcome rows may repeat
+// a rowId (e.g. to request several prediction times)
+class NewDataScorer {
+public:
+    NewDataScorer(const std::vector<int64_t>& rowIds,
+                  const std::vector<int64_t>& covariateIds,
+                  const std::vector<double>& beta,
+                  double intercept)
+        : covariates(covariateIds), beta(beta), position(rowIds.size()) {
+
+        std::vector<int64_t> uniqueIds(rowIds);
+        std::sort(std::begin(uniqueIds), std::end(uniqueIds));
+        uniqueIds.erase(std::unique(std::begin(uniqueIds), std::end(uniqueIds)), std::end(uniqueIds));
+
+        rows = IdIndex(uniqueIds);
+        for (size_t i = 0; i < rowIds.size(); ++i) {
+            position[i] = rows.find(rowIds[i]);
+        }
+        linearPredictor.assign(uniqueIds.size(), intercept);
+    }
+
+    void accumulate(const std::vector<int64_t>& rowId,
+                    const std::vector<int64_t>& covariateId,
+                    const std::vector<double>& covariateValue) {
+        const bool indicator = covariateValue.empty();
+        for (size_t k = 0; k < rowId.size(); ++k) {
+            const auto j = covariates.find(covariateId[k]);
+            if (j < 0) continue;
+            const auto i = rows.find(rowId[k]);
+            if (i < 0) continue;
+            linearPredictor[i] += indicator ? beta[j] : beta[j] * covariateValue[k];
+        }
+    }
+
+    std::vector<double> getLinearPredictor() const {
+        std::vector<double> eta(position.size());
+        for (size_t i = 0; i < position.size(); ++i) {
+            eta[i] = linearPredictor[position[i]];
+        }
+        return eta;
+    }
+
+private:
+    IdIndex rows;
+    IdIndex covariates;
+    std::vector<double> beta;
+    std::vector<long> position;
+    std::vector<double> linearPredictor;
+};
+
+} // namespace bsccs
+
+// [[Rcpp::export(".cyclopsNewDataScorer")]]
+SEXP cyclopsNewDataScorer(const std::vector<double>& rowId,
+                          const std::vector<double>& covariateId,
+                          const std::vector<double>& beta,
+                          double intercept) {
+    using namespace bsccs;
+
+    if (covariateId.size() != beta.size()) {
+        Rcpp::stop("Vector length mismatch");
+    }
+
+    XPtr<NewDataScorer> scorer(
+        new NewDataScorer(reinterpret_cast<const std::vector<int64_t>&>(rowId),
+                          reinterpret_cast<const std::vector<int64_t>&>(covariateId),
+                          beta, intercept));
+    return scorer;
+}
+
+// [[Rcpp::export(".cyclopsScoreNewData")]]
+void cyclopsScoreNewData(SEXP inScorer,
+                         const std::vector<double>& rowId,
+                         const std::vector<double>& covariateId,
+                         const std::vector<double>& covariateValue) {
+    using namespace bsccs;
+    XPtr<NewDataScorer> scorer(inScorer);
+
+    if (rowId.size() != covariateId.size() ||
+        (covariateValue.size() > 0 && covariateValue.size() != rowId.size())) {
+        Rcpp::stop("Vector length mismatch");
+    }
+
+    scorer->accumulate(reinterpret_cast<const std::vector<int64_t>&>(rowId),
+                       reinterpret_cast<const std::vector<int64_t>&>(covariateId),
+                       covariateValue);
+}
+
+// [[Rcpp::export(".cyclopsGetNewDataPredictions")]]
+NumericVector cyclopsGetNewDataPredictions(SEXP inScorer,
+                                           const std::string& modelType,
+                                           const std::vector<double>& time,
+                                           const std::vector<double>& stratumId,
+                                           const std::vector<double>& baselineTime,
+                                           const std::vector<double>& baselineCumulativeHazard) {
+    using namespace bsccs;
+    XPtr<NewDataScorer> scorer(inScorer);
+
+    const auto eta = scorer->getLinearPredictor();
+    const size_t n = eta.size();
+    NumericVector prediction(n);
+
+    if (modelType == "lr") {
+        for (size_t i = 0; i < n; ++i) {
+            prediction[i] = 1.0 / (1.0 + std::exp(-eta[i]));
+        }
+    } else if (modelType == "pr") {
+        for (size_t i = 0; i < n; ++i) {
+            prediction[i] = std::exp(eta[i]) * (time.empty() ? 1.0 : time[i]);
+        }
+    } else if (modelType == "cox") {
+        // S(t | x) = exp(-H0(t) exp(x beta)), with H0 a right-continuous step function
+        if (time.size() != n) {
+            Rcpp::stop("Survival predictions require a time for each row");
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const auto it = std::upper_bound(std::begin(baselineTime), std::end(baselineTime), time[i]);
+            const double hazard = (it == std::begin(baselineTime)) ? 0.0 :
+                baselineCumulativeHazard[std::distance(std::begin(baselineTime), it) - 1];
+            prediction[i] = std::exp(-hazard * std::exp(eta[i]));
+        }
+    } else if (modelType == "clr" || modelType == "cpr") {
+        // Probability (or expected share of events) within stratum
+        if (stratumId.size() != n) {
+            Rcpp::stop("Conditional predictions require a stratumId for each row");
+        }
+        std::unordered_map<double, double> denominator;
+        for (size_t i = 0; i < n; ++i) {
+            denominator[stratumId[i]] += std::exp(eta[i]);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            prediction[i] = std::exp(eta[i]) / denominator[stratumId[i]];
+        }
+    } else { // Linear predictor
+        std::copy(std::begin(eta), std::end(eta), prediction.begin());
+    }
+
+    return prediction;
+}
@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <iterator>
 
 #include <iostream>
 #include <time.h>
@@ -136,12 +137,12 @@ using namespace std;
 	}
 #endif
 
-CcdInterface::CcdInterface(void) {
+CcdInterface::CcdInterface(void) : workerPool(bsccs::make_shared<WorkerPool>()) {
     setDefaultArguments();
 }
 
 CcdInterface::~CcdInterface(void) {
-    // Do nothing
+    workerPool->shutdown();
 }
 
 double CcdInterface::calculateSeconds(const timeval &time1, const timeval &time2) {
@@ -194,6 +195,7 @@ double CcdInterface::initializeModel(
 	gettimeofday(&time1, NULL);
 
     initializeModelImpl(modelData, ccd, model);
+    (*ccd)->setWorkerPool(workerPool);
 
 	gettimeofday(&time2, NULL);
 	return calculateSeconds(time1, time2);
@@ -220,15 +222,79 @@ double CcdInterface::predictModel(CyclicCoordinateDescent *ccd, AbstractModelDat
 	return calculateSeconds(time1, time2);
 }
 
+// Conditional modes found while profiling, keyed by covariate and fixed value.  Shared by all
+// searches over the same covariate, so probes can be re-used and warm-started from neighbors.
+class ProfileCache {
+public:
+
+	void insert(int index, double x, const std::vector<double>& beta, double value) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		cache[index][x] = Entry{beta, value};
+	}
+
+	bool find(int index, double x, double& value) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto column = cache.find(index);
+		if (column != cache.end()) {
+			auto entry = column->second.find(x);
+			if (entry != column->second.end()) {
+				value = entry->second.value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool nearest(int index, double x, std::vector<double>& beta) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto column = cache.find(index);
+		if (column == cache.end() || column->second.empty()) {
+			return false;
+		}
+		const auto& points = column->second;
+		auto above = points.lower_bound(x);
+		auto closest = above;
+		if (above == points.end() ||
+				(above != points.begin() && x - std::prev(above)->first < above->first - x)) {
+			closest = std::prev(above);
+		}
+		beta = closest->second.beta;
+		return true;
+	}
+
+	void open(int index, int users) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		remaining[index] += users;
+	}
+
+	void close(int index) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		if (--remaining[index] <= 0) {
+			cache.erase(index); // Release memory once all searches are done
+		}
+	}
+
+private:
+	struct Entry {
+		std::vector<double> beta;
+		double value;
+	};
+
+	std::map<int, std::map<double, Entry>> cache;
+	std::map<int, int> remaining;
+	bsccs::mutex lock;
+};
+
 struct OptimizationProfile {
 
 	CyclicCoordinateDescent& ccd;
 	CCDArguments& arguments;
 
 	OptimizationProfile(CyclicCoordinateDescent& _ccd, CCDArguments& _arguments, int _index, double _max,
-			double _threshold = 1.920729, bool _includePenalty = false) :
+			double _threshold = 1.920729, bool _includePenalty = false,
+			ProfileCache* _cache = nullptr) :
 			ccd(_ccd), arguments(_arguments), index(_index), max(_max), threshold(_threshold),
-			nEvals(0), includePenalty(_includePenalty) {
+			nEvals(0), includePenalty(_includePenalty), cache(_cache) {
 	}
 
 	int getEvaluations() {
@@ -236,16 +302,35 @@ struct OptimizationProfile {
 	}
 
 	double objective(double x) {
+		double y;
+		if (cache && cache->find(index, x, y)) {
+			return y + threshold - max;
+		}
+
 		++nEvals;
-		ccd.setBeta(index, x);
+		if (cache && cache->nearest(index, x, start)) {
+			start[index] = x;
+			ccd.setBeta(start); // Warm start from closest conditional mode
+		} else {
+			ccd.setBeta(index, x);
+		}
 		ccd.setFixedBeta(index, true);
 		ccd.update(arguments.modeFinding);
 		ccd.setFixedBeta(index, false);
-		double y = ccd.getLogLikelihood() + threshold - max;
+		y = ccd.getLogLikelihood();
 		if (includePenalty) {
 			y += ccd.getLogPrior();
 		}
-		return y;
+
+		if (cache) {
+			const int J = ccd.getBetaSize();
+			start.resize(J);
+			for (int j = 0; j < J; ++j) {
+				start[j] = ccd.getBeta(j);
+			}
+			cache->insert(index, x, start, y);
+		}
+		return y + threshold - max;
 	}
 
 	double getMaximum() {
@@ -257,6 +342,8 @@ struct OptimizationProfile {
 	double threshold;
 	int nEvals;
 	bool includePenalty;
+	ProfileCache* cache;
+	std::vector<double> start;
 };
 
 double CcdInterface::profileModel(CyclicCoordinateDescent *ccd, AbstractModelData *modelData,
@@ -309,30 +396,32 @@ double CcdInterface::profileModel(CyclicCoordinateDescent *ccd, AbstractModelDat
 	}
 
 	// Parallelize across columns and lower/upper bound
-	int nThreads = (inThreads == -1) ?
-	    bsccs::thread::hardware_concurrency() : inThreads;
+	int nThreads = ccd->getUsableThreads((inThreads == -1) ?
+	    bsccs::thread::hardware_concurrency() : inThreads);
 
 	std::ostringstream stream2;
 	stream2 << "Using " << nThreads << " thread(s)";
 	logger->writeLine(stream2);
 
-	std::vector<CyclicCoordinateDescent*> ccdPool;
-
-	ccdPool.push_back(ccd);
-
-	for (int i = 1; i < nThreads; ++i) {
-	    ccdPool.push_back(ccd->clone());
-	}
+	std::vector<CyclicCoordinateDescent*> ccdPool = ccd->cloneForThreads(nThreads);
 
     std::vector<double> lowerPts(indices.size());
 	std::vector<double> upperPts(indices.size());
 	std::vector<int> lowerCnts(indices.size());
 	std::vector<int> upperCnts(indices.size());
 
+	// Upper and lower searches share conditional modes; both start from the joint mode
+	ProfileCache cache;
+	for (auto index : indices) {
+	    cache.insert(index, x0s[index], x0s, mode);
+	    cache.open(index, 2);
+	}
+
 	auto getBound = [this,
 	            &x0s,
 	            &indices, &lowerPts, &upperPts,
-                &lowerCnts, &upperCnts, includePenalty, mode, threshold
+                &lowerCnts, &upperCnts, includePenalty, mode, threshold,
+                &cache
             ](const BoundType bound, CyclicCoordinateDescent* ccd) {
 	    const auto id = std::get<0>(bound);
 	    const auto direction = std::get<1>(bound);
@@ -341,7 +430,7 @@ double CcdInterface::profileModel(CyclicCoordinateDescent *ccd, AbstractModelDat
 	    double x0 = x0s[index];
 
 	    // Bound edge
-	    OptimizationProfile eval(*ccd, arguments, index, mode, threshold, includePenalty);
+	    OptimizationProfile eval(*ccd, arguments, index, mode, threshold, includePenalty, &cache);
 	    RZeroIn<OptimizationProfile> zeroIn(eval, 1E-3);
 
 	    double obj0 = eval.getMaximum();
@@ -353,6 +442,8 @@ double CcdInterface::profileModel(CyclicCoordinateDescent *ccd, AbstractModelDat
 
 	    double pt = std::isnan(bracket.second) ? NAN : zeroIn.getRoot(x0, bracket.first, obj0, bracket.second);
 
+	    cache.close(index);
+
 	    if (direction == 1.0) {
 	        upperPts[id] = pt;
 	        upperCnts[id] = eval.getEvaluations();
@@ -372,7 +463,7 @@ double CcdInterface::profileModel(CyclicCoordinateDescent *ccd, AbstractModelDat
         auto scheduler = TaskScheduler<boost::counting_iterator<int> >(
             boost::make_counting_iterator(0),
             boost::make_counting_iterator(static_cast<int>(bounds.size())),
-            nThreads);
+            nThreads, ccd->getWorkerPool());
 
         auto oneTask = [&getBound, &scheduler, &ccdPool, &bounds](unsigned long task) {
             getBound(bounds[task], ccdPool[scheduler.getThreadIndex(task)]);
@@ -543,8 +634,8 @@ double CcdInterface::evaluateProfileModel(CyclicCoordinateDescent *ccd, Abstract
     }
 
     // Parallelize across grid values
-    int nThreads = (inThreads == -1) ?
-    bsccs::thread::hardware_concurrency() : inThreads;
+    int nThreads = ccd->getUsableThreads((inThreads == -1) ?
+    bsccs::thread::hardware_concurrency() : inThreads);
 
     double mode = ccd->getLogLikelihood(); // TODO Remove
 
@@ -570,12 +661,7 @@ double CcdInterface::evaluateProfileModel(CyclicCoordinateDescent *ccd, Abstract
     ccd->makeDirty(); // Reset internal memory
     evaluate(0.0, ccd);
 
-    std::vector<CyclicCoordinateDescent*> ccdPool;
-    ccdPool.push_back(ccd);
-
-    for (int i = 1; i < nThreads; ++i) {
-        ccdPool.push_back(ccd->clone());
-    }
+    std::vector<CyclicCoordinateDescent*> ccdPool = ccd->cloneForThreads(nThreads);
 
     if (nThreads == 1) {
         for (int i = 0; i < points.size(); ++i) {
@@ -583,7 +669,8 @@ double CcdInterface::evaluateProfileModel(CyclicCoordinateDescent *ccd, Abstract
         }
     } else {
         auto scheduler = TaskScheduler<boost::counting_iterator<int>>(
-            boost::make_counting_iterator(0), boost::make_counting_iterator(static_cast<int>(points.size())), nThreads);
+            boost::make_counting_iterator(0), boost::make_counting_iterator(static_cast<int>(points.size())), nThreads,
+            ccd->getWorkerPool());
 
         auto oneTask = [&evaluate, &scheduler, &ccdPool, &points, &values](unsigned long task) {
             values[task] = evaluate(points[task], ccdPool[scheduler.getThreadIndex(task)]);
@@ -618,6 +705,180 @@ double CcdInterface::evaluateProfileModel(CyclicCoordinateDescent *ccd, Abstract
     return calculateSeconds(time1, time2);
 }
 
+// Limits on the adaptive profile grid: refinement rounds, evaluated points, and the fraction of
+// the tolerance required on intervals that bracket the threshold crossing
+const int maxProfileRounds = 20;
+const size_t maxProfilePoints = 1000;
+const double profileCrossingFactor = 0.1;
+
+// Adaptive evaluation over [lowerBound, upperBound]: start from a coarse uniform grid and bisect
+// only intervals where linear interpolation is not yet accurate to `tolerance` (log-likelihood
+// units) or that bracket the likelihood-ratio threshold crossing.
+double CcdInterface::evaluateProfileModel(CyclicCoordinateDescent *ccd, AbstractModelData *modelData,
+                                          const IdType covariate,
+                                          double lowerBound,
+                                          double upperBound,
+                                          int initialGridSize,
+                                          double tolerance,
+                                          double threshold,
+                                          std::vector<double>& points,
+                                          std::vector<double>& values,
+                                          int inThreads,
+                                          bool includePenalty) {
+
+    struct timeval time1, time2;
+    gettimeofday(&time1, NULL);
+
+    int index = modelData->getColumnIndexByName(covariate);
+
+    if (index == -1) {
+        std::ostringstream stream;
+        stream << "Variable " << covariate << " not found.";
+        error->throwError(stream);
+    }
+
+    if (!(lowerBound < upperBound) || initialGridSize < 2) {
+        std::ostringstream stream;
+        stream << "Invalid adaptive profile grid.";
+        error->throwError(stream);
+    }
+
+    int nThreads = ccd->getUsableThreads((inThreads == -1) ?
+    bsccs::thread::hardware_concurrency() : inThreads);
+
+    std::ostringstream stream2;
+    stream2 << "Using " << nThreads << " thread(s)";
+    logger->writeLine(stream2);
+
+    int J = ccd->getBetaSize();
+    std::vector<double> x0s(J);
+    for (int j = 0; j < J; ++j) {
+        x0s[j] = ccd->getBeta(j);
+    }
+
+    double mode = ccd->getLogLikelihood();
+    if (includePenalty) {
+        mode += ccd->getLogPrior();
+    }
+    const double crossing = mode - threshold;
+
+    // Refinements warm-start from the closest point already evaluated
+    ProfileCache cache;
+    cache.insert(index, x0s[index], x0s, mode);
+
+    std::vector<CyclicCoordinateDescent*> ccdPool = ccd->cloneForThreads(nThreads);
+
+    auto evaluate = [this, index, includePenalty, &cache](const double point,
+                                                           CyclicCoordinateDescent* ccd) {
+
+        OptimizationProfile eval(*ccd, arguments, index,
+                                 0.0, 0.0, includePenalty, &cache);
+
+        return eval.objective(point);
+    };
+
+    auto evaluateAll = [&](const std::vector<double>& batch, std::vector<double>& result) {
+        result.resize(batch.size());
+        if (nThreads == 1 || batch.size() == 1) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                result[i] = evaluate(batch[i], ccd);
+            }
+        } else {
+            auto scheduler = TaskScheduler<boost::counting_iterator<int>>(
+                boost::make_counting_iterator(0), boost::make_counting_iterator(static_cast<int>(batch.size())), nThreads,
+                ccd->getWorkerPool());
+
+            auto oneTask = [&evaluate, &scheduler, &ccdPool, &batch, &result](unsigned long task) {
+                result[task] = evaluate(batch[task], ccdPool[scheduler.getThreadIndex(task)]);
+            };
+
+            ccd->getProgressLogger().setConcurrent(true);
+            ccd->getErrorHandler().setConcurrent(true);
+            scheduler.execute(oneTask);
+            ccd->getProgressLogger().setConcurrent(false);
+            ccd->getErrorHandler().setConcurrent(false);
+            ccd->getProgressLogger().flush();
+            ccd->getErrorHandler().flush();
+        }
+    };
+
+    std::map<double, double> samples;
+
+    std::vector<double> batch;
+    std::vector<double> result;
+    for (int i = 0; i < initialGridSize; ++i) {
+        batch.push_back(lowerBound + (upperBound - lowerBound) * i / (initialGridSize - 1));
+    }
+
+    int round = 0;
+    while (!batch.empty()) {
+
+        evaluateAll(batch, result);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            samples[batch[i]] = result[i];
+        }
+
+        if (++round >= maxProfileRounds || samples.size() >= maxProfilePoints) {
+            break;
+        }
+
+        std::vector<double> x, y;
+        for (const auto& sample : samples) {
+            x.push_back(sample.first);
+            y.push_back(sample.second);
+        }
+
+        // Second divided difference ~ f''/2 over three consecutive samples
+        const int n = x.size();
+        std::vector<double> dd2(n, 0.0);
+        for (int i = 1; i < n - 1; ++i) {
+            const double left = (y[i] - y[i - 1]) / (x[i] - x[i - 1]);
+            const double right = (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+            dd2[i] = std::abs((right - left) / (x[i + 1] - x[i - 1]));
+        }
+
+        batch.clear();
+        for (int i = 0; i < n - 1; ++i) {
+            const double h = x[i + 1] - x[i];
+            const double curvature = std::max(dd2[i], dd2[i + 1]);
+            const double interpolationError = curvature * h * h / 4.0;
+
+            const bool crosses = (y[i] - crossing) * (y[i + 1] - crossing) < 0.0;
+            const double bound = crosses ? tolerance * profileCrossingFactor : tolerance;
+
+            if (interpolationError > bound || (std::isnan(interpolationError) && h > tolerance)) {
+                batch.push_back(x[i] + h / 2.0);
+            }
+        }
+
+        if (arguments.noiseLevel >= NOISY) {
+            std::ostringstream stream;
+            stream << "Profile refinement #" << round << ": " << batch.size() << " new point(s)";
+            logger->writeLine(stream);
+        }
+    }
+
+    points.clear();
+    values.clear();
+    for (const auto& sample : samples) {
+        points.push_back(sample.first);
+        values.push_back(sample.second);
+    }
+
+    // Reset
+    for (int j = 0; j < J; ++j) {
+        ccd->setBeta(j, x0s[j]);
+    }
+
+    // Clean up copies
+    for (int i = 1; i < nThreads; ++i) {
+        delete ccdPool[i]; // TODO use shared_ptr
+    }
+
+    gettimeofday(&time2, NULL);
+    return calculateSeconds(time1, time2);
+}
+
 double CcdInterface::diagnoseModel(CyclicCoordinateDescent *ccd, AbstractModelData *modelData,
 		double loadTime,
 		double updateTime) {
@@ -664,7 +925,9 @@ double CcdInterface::fitModel(CyclicCoordinateDescent *ccd) {
 	//Eric: Commented this out.
 	//std::vector<double> weights(7, 1.0);
 	//ccd->setWeights(weights.data());
+	ccd->setThreads(arguments.threads);
 	ccd->update(arguments.modeFinding);
+	ccd->setThreads(1); // Cross-validation and profiling parallelize across clones instead
 
 	gettimeofday(&time2, NULL);
 
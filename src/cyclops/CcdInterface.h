@@ -21,6 +21,7 @@
 // #endif
 
 #include "Types.h"
+#include "Thread.h"
 #include "io/ProgressLogger.h"
 
 namespace bsccs {
@@ -34,6 +35,7 @@ struct CrossValidationArguments {
     // All options related to cross-validation go here
 	bool doCrossValidation;
 	bool useAutoSearchCV;
+	bool useBatchSearch;
 	double lowerLimit;
 	double upperLimit;
 	int fold;
@@ -43,10 +45,13 @@ struct CrossValidationArguments {
 	bool doFitAtOptimal;
     double startingVariance;
     SelectorType selectorType;
+    std::string checkpointFileName; // Empty disables checkpoints
+    int checkpointInterval;
 
     CrossValidationArguments() :
         doCrossValidation(false),
         useAutoSearchCV(false),
+        useBatchSearch(false),
         lowerLimit(0.01),
         upperLimit(20.0),
         fold(10),
@@ -55,7 +60,9 @@ struct CrossValidationArguments {
         cvFileName("cv.txt"),
         doFitAtOptimal(true),
         startingVariance(-1),   // Use default from Genkins et al.
-        selectorType(SelectorType::BY_PID)
+        selectorType(SelectorType::BY_PID),
+        checkpointFileName(""),
+        checkpointInterval(1)
         { }
 };
 
@@ -79,6 +86,8 @@ struct ModeFindingArguments {
 	double initialBound;
 	int maxBoundCount;
 	AlgorithmType algorithmType;
+	int newtonMaxCovariates;
+	int stationaryCycles;
 
 	ModeFindingArguments() :
 		tolerance(1E-6),
@@ -89,7 +98,9 @@ struct ModeFindingArguments {
 		swindleMultipler(10),
 		initialBound(2.0),
 		maxBoundCount(5),
-		algorithmType(AlgorithmType::CCD)
+		algorithmType(AlgorithmType::CCD),
+		newtonMaxCovariates(250),
+		stationaryCycles(0)
 	    { }
 };
 
@@ -187,6 +198,20 @@ public:
             int threads,
             bool includePenalty);
 
+    double evaluateProfileModel(
+            CyclicCoordinateDescent *ccd,
+            AbstractModelData *modelData,
+            const IdType covariate,
+            double lowerBound,
+            double upperBound,
+            int initialGridSize,
+            double tolerance,
+            double threshold,
+            std::vector<double>& points,
+            std::vector<double>& values,
+            int threads,
+            bool includePenalty);
+
     double runCrossValidation(
             CyclicCoordinateDescent *ccd,
             AbstractModelData *modelData);
@@ -252,6 +277,9 @@ protected:
     loggers::ProgressLoggerPtr logger;
     loggers::ErrorHandlerPtr error;
 
+    // Worker threads are started on first parallel use and reused for the life of the interface
+    WorkerPoolPtr workerPool;
+
 }; // class CcdInterface
 
 // class RCcdInterface: public CcdInterface {
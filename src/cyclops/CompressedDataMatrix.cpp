@@ -13,6 +13,7 @@
 #include <stdexcept>
 
 #include "CompressedDataMatrix.h"
+#include "io/ColumnStore.h"
 
 namespace bsccs {
 
@@ -127,9 +128,15 @@ FormatType CompressedDataMatrix<RealType>::getFormatType(int column) const {
 
 template <typename RealType>
 void CompressedDataColumn<RealType>::fill(RealVector& values, int nRows) const {
+	page();
 	values.resize(nRows);
 	if (formatType == DENSE) {
 			values.assign(data->begin(), data->end());
+		} else if (formatType == INTERACTION) {
+			values.assign(nRows, static_cast<RealType>(0));
+			forEachInteractionEntry([&values](int k, RealType value) {
+				values[k] = value;
+			});
 		} else {
 			bool isSparse = formatType == SPARSE;
 			values.assign(nRows, static_cast<RealType>(0));
@@ -164,6 +171,8 @@ CompressedDataMatrix<RealType>::transpose() const {
 			flagDense = true;
 		if (thisFormatType == INDICATOR)
 			flagIndicator = true;
+		if (thisFormatType == INTERACTION)
+			flagIndicator = flagDense = true; // Products need SPARSE storage
 	}
 
 	if (flagIndicator && flagDense) {
@@ -197,6 +206,10 @@ CompressedDataMatrix<RealType>::transpose() const {
 			for (int j = 0; j < rows; ++j) {
 				matTranspose->getColumn(j).add_data(i, 1.0);
 			}
+		} else if (thisFormatType == INTERACTION) {
+			this->allColumns[i]->forEachInteractionEntry([&matTranspose, i](int k, RealType value) {
+				matTranspose->getColumn(k).add_data(i, value);
+			});
 		} else {
 			for (size_t j = 0; j < nRows; j++) {
 				matTranspose->getColumn(j).add_data(i,
@@ -225,7 +238,14 @@ void CompressedDataMatrix<RealType>::getDataRow(int row, RealType* x) const {
 	{
 		if(this->allColumns[j]->getFormatType() == DENSE)
 			x[j] = this->getDataVector(j)[row];
-		else{
+		else if (this->allColumns[j]->getFormatType() == INTERACTION) {
+			x[j] = 0.0;
+			this->allColumns[j]->forEachInteractionEntry([x, j, row](int k, RealType value) {
+				if (k == row) {
+					x[j] = value;
+				}
+			});
+		} else{
 			x[j] = 0.0;
 			int* col = this->getCompressedColumnVector(j);
 			for(size_t i = 0; i < this->allColumns[j]->getNumberOfEntries(); i++){
@@ -262,10 +282,17 @@ RealType CompressedDataColumn<RealType>::sumColumn(int nRows) { // TODO Depricat
 
 template <typename RealType>
 RealType CompressedDataColumn<RealType>::squaredSumColumn(size_t n) const {
+	page();
 	if (formatType == INDICATOR) {
 		return getNumberOfEntries();
 	} else if (formatType == INTERCEPT) {
 	    return static_cast<RealType>(n);
+	} else if (formatType == INTERACTION) {
+		RealType sum = static_cast<RealType>(0);
+		forEachInteractionEntry([&sum](int, RealType value) {
+			sum += value * value;
+		});
+		return sum;
 	} else {
 		return std::inner_product( data->begin(), data->end(), data->begin(), static_cast<RealType>(0));
 	}
@@ -273,6 +300,7 @@ RealType CompressedDataColumn<RealType>::squaredSumColumn(size_t n) const {
 
 template <typename RealType>
 void CompressedDataColumn<RealType>::convertColumnToSparse(void) {
+	page();
 	if (formatType == SPARSE) {
 		return;
 	}
@@ -291,10 +319,22 @@ void CompressedDataColumn<RealType>::convertColumnToSparse(void) {
 
 template <typename RealType>
 void CompressedDataColumn<RealType>::convertColumnToDense(int nRows) {
+	page();
 	if (formatType == DENSE) {
 		return;
 	}
 
+	if (formatType == INTERACTION) {
+		RealVectorPtr values = make_shared<RealVector>();
+		fill(*values, nRows);
+		data = values;
+		columns = NULL;
+		secondColumns = NULL;
+		secondData = NULL;
+		formatType = DENSE;
+		return;
+	}
+
     RealVectorPtr oldData = data;
     data = make_shared<RealVector>();
 
@@ -323,6 +363,7 @@ void CompressedDataColumn<RealType>::convertColumnToDense(int nRows) {
 // TODO Fix massive copying
 template <typename RealType>
 void CompressedDataColumn<RealType>::addToColumnVector(IntVector addEntries){
+	page();
 	int lastit = 0;
 
 	for(int i = 0; i < (int)addEntries.size(); i++)
@@ -340,6 +381,7 @@ void CompressedDataColumn<RealType>::addToColumnVector(IntVector addEntries){
 
 template <typename RealType>
 void CompressedDataColumn<RealType>::removeFromColumnVector(IntVector removeEntries){
+	page();
 	int lastit = 0;
 	IntVector::iterator it1 = removeEntries.begin();
 	IntVector::iterator it2 = columns->begin();
@@ -371,6 +413,10 @@ void CompressedDataColumn<RealType>::printMatrixMarketFormat(std::ostream& strea
             double value = (formatType == SPARSE) ? getDataVector()[i] : 1.0;
             stream << (columns[i] + 1) << " " << (columnNumber + 1) <<  " " << value << "\n";
         }
+    } else if (formatType == INTERACTION) {
+        forEachInteractionEntry([&stream, columnNumber](int k, RealType value) {
+            stream << (k + 1) << " " << (columnNumber + 1) <<  " " << value << "\n";
+        });
     } else {
         throw new std::invalid_argument("Unknon type");
     }
@@ -393,6 +439,19 @@ void CompressedDataMatrix<RealType>::printMatrixMarketFormat(std::ostream& strea
     }
 }
 
+template <typename RealType>
+void CompressedDataMatrix<RealType>::spillToFile(const std::string& fileName, size_t cacheBytes,
+		int readAhead) {
+	if (columnStore) {
+		throw std::logic_error("Columns are already out-of-core");
+	}
+	if (hasInteractions()) {
+		throw std::invalid_argument("Interaction columns share storage and cannot be spilled");
+	}
+	columnStore = bsccs::make_shared<ColumnStore<RealType>>(allColumns, fileName, cacheBytes,
+		readAhead);
+}
+
 // Instantiate classes
 template class CompressedDataColumn<double>;
 template class CompressedDataColumn<float>;
@@ -34,7 +34,16 @@ namespace bsccs {
 // typedef bsccs::shared_ptr<RealVector> RealVectorPtr;
 
 enum FormatType {
-	DENSE, SPARSE, INDICATOR, INTERCEPT
+	DENSE, SPARSE, INDICATOR, INTERCEPT, INTERACTION
+};
+
+// Source of column payloads for an out-of-core matrix, see io/ColumnStore.h
+class ColumnPager {
+public:
+	virtual ~ColumnPager() { }
+
+	// Makes the payload of column 'index' resident
+	virtual void page(int index) = 0;
 };
 
 template <typename RealType>
@@ -52,10 +61,22 @@ public:
 	CompressedDataColumn(IntVectorPtr colIndices, RealVectorPtr colData, FormatType colFormat,
 			std::string colName = "", IdType nName = 0, bool sPtrs = false) :
 		 columns(colIndices), data(colData), formatType(colFormat), stringName(colName),
-		 numericalName(nName), sharedPtrs(sPtrs) {
+		 numericalName(nName), sharedPtrs(sPtrs), interactionEntries(0),
+		 pager(nullptr), pagerIndex(-1), releasedEntries(0) {
 		// Do nothing
 	}
 
+	// Virtual product of two SPARSE or INDICATOR columns; shares their storage and
+	// yields the entries common to both, see InteractionIterator
+	CompressedDataColumn(const CompressedDataColumn& first, const CompressedDataColumn& second,
+			IdType nName) :
+		 columns(first.columns), data(first.formatType == SPARSE ? first.data : nullptr),
+		 secondColumns(second.columns), secondData(second.formatType == SPARSE ? second.data : nullptr),
+		 formatType(INTERACTION), numericalName(nName), sharedPtrs(true),
+		 pager(nullptr), pagerIndex(-1), releasedEntries(0) {
+		countInteractionEntries();
+	}
+
 	virtual ~CompressedDataColumn() {
 	    // Only release data if not shared
 //		if (columns && !sharedPtrs) {
@@ -67,42 +88,51 @@ public:
 	}
 
 	int* getColumns() const {
+		page();
 		return static_cast<int*>(columns->data());
 	}
 
 	RealType* getData() const {
+		page();
 		return static_cast<RealType*>(data->data());
 	}
 
 	const IntVector& getColumnsVector() const {
+		page();
 		return *columns;
 	}
 
 	const RealVector& getDataVector() const {
+		page();
 		return *data;
 	}
 
 	IntVector& getColumnsVector() {
+		page();
 		return *columns;
 	}
 
 	RealVector& getDataVector() {
+		page();
 		return *data;
 	}
 
 	RealVector copyData() {
 // 		std::vector copy(std::begin(data), std::end(data));
 // 		return std::move(copy);
+		page();
 		return RealVector(*data);
 	}
 
 	template <typename Function>
 	void transform(Function f) {
+	    page();
 	    std::transform(data->begin(), data->end(), data->begin(), f);
 	}
 
 	template <typename Function, typename ValueType>
 	ValueType accumulate(Function f, ValueType x) {
+	    page();
 	    return std::accumulate(data->begin(), data->end(), x, f);
 	}
 
@@ -133,6 +163,8 @@ public:
 			str = "indicator";
 		} else if (formatType == INTERCEPT) {
 			str = "intercept";
+		} else if (formatType == INTERACTION) {
+			str = "interaction";
 		} else {
 			str = "unknown";
 		}
@@ -140,11 +172,131 @@ public:
 	}
 
 	size_t getNumberOfEntries() const {
-		return columns->size();
+		if (formatType == INTERACTION) {
+			return interactionEntries;
+		}
+		return isResident() ? columns->size() : releasedEntries;
+	}
+
+	// Columns of an out-of-core matrix drop their payload when evicted and get it back from
+	// their pager on the next access; see CompressedDataMatrix::spillToFile()
+	void setPager(ColumnPager* columnPager, int index) {
+		pager = columnPager;
+		pagerIndex = index;
+	}
+
+	bool isResident() const {
+		return !pager || columns || data;
+	}
+
+	void releasePayload() {
+		releasedEntries = columns ? columns->size() : (data ? data->size() : 0);
+		columns.reset();
+		data.reset();
+	}
+
+	void restorePayload(IntVectorPtr colIndices, RealVectorPtr colData) {
+		columns = colIndices;
+		data = colData;
+	}
+
+	// Factor storage of an INTERACTION column; values are nullptr for indicator factors
+	const IntVector& getFirstColumnsVector() const {
+		return *columns;
+	}
+
+	const IntVector& getSecondColumnsVector() const {
+		return *secondColumns;
+	}
+
+	const RealType* getFirstValues() const {
+		return data ? data->data() : nullptr;
+	}
+
+	const RealType* getSecondValues() const {
+		return secondData ? secondData->data() : nullptr;
+	}
+
+	// Calls f(row, value) for each entry of an INTERACTION column, in row order
+	template <typename Function>
+	void forEachInteractionEntry(Function f) const {
+		const IntVector& one = *columns;
+		const IntVector& two = *secondColumns;
+		size_t i = 0;
+		size_t j = 0;
+		while (i < one.size() && j < two.size()) {
+			if (one[i] < two[j]) {
+				++i;
+			} else if (two[j] < one[i]) {
+				++j;
+			} else {
+				f(one[i], (data ? (*data)[i] : static_cast<RealType>(1)) *
+					(secondData ? (*secondData)[j] : static_cast<RealType>(1)));
+				++i;
+				++j;
+			}
+		}
+	}
+
+	void countInteractionEntries() {
+		size_t count = 0;
+		forEachInteractionEntry([&count](int, RealType) { ++count; });
+		interactionEntries = count;
+	}
+
+	// True if both columns have the same format, row set and values
+	bool hasSameEntries(const CompressedDataColumn& other) const {
+		page();
+		other.page();
+		if (formatType != other.formatType) {
+			return false;
+		}
+		if (formatType == INTERACTION) {
+			return columns == other.columns && data == other.data &&
+				secondColumns == other.secondColumns && secondData == other.secondData;
+		}
+		const bool sameRows = (columns && other.columns) ?
+			*columns == *other.columns : columns == other.columns;
+		const bool sameData = (data && other.data) ?
+			*data == *other.data : data == other.data;
+		return sameRows && sameData;
 	}
 
 	size_t getDataVectorLength() const {
-		return data->size();
+		return isResident() ? data->size() : releasedEntries;
+	}
+
+	// Keeps only entries whose row maps to a non-negative index in 'newRow', renumbering them
+	void compressRows(const std::vector<int>& newRow) {
+		if (formatType == INTERCEPT || formatType == INTERACTION) {
+			return; // Factors of an INTERACTION are compressed through their own columns
+		}
+		page();
+		if (formatType == DENSE) {
+			size_t kept = 0;
+			for (size_t k = 0; k < data->size(); ++k) {
+				if (newRow[k] >= 0) {
+					(*data)[kept++] = (*data)[k];
+				}
+			}
+			data->resize(kept);
+			return;
+		}
+		size_t kept = 0;
+		for (size_t i = 0; i < columns->size(); ++i) {
+			const int row = newRow[(*columns)[i]];
+			if (row >= 0) {
+				(*columns)[kept] = row;
+				if (formatType == SPARSE) {
+					(*data)[kept] = (*data)[i];
+				}
+				++kept;
+			}
+		}
+		columns->resize(kept);
+		if (formatType == SPARSE) {
+			data->resize(kept);
+		}
 	}
 
 	void add_label(std::string label) {
@@ -157,6 +309,7 @@ public:
 
 	template <typename T> // *** TODO FP remove template?
 	bool add_data(int row, T value) {
+		page();
 		if (formatType == DENSE) {
 			//Making sure that we are at the correct row
 			for(int i = data->size(); i < row; i++) {
@@ -182,6 +335,8 @@ public:
 			}
 		} else if (formatType == INTERCEPT) {
 			// Do nothing
+		} else if (formatType == INTERACTION) {
+			throw new std::invalid_argument("Cannot add data to an interaction");
 		} else {
             throw new std::invalid_argument("Unknown type");
 		}
@@ -231,15 +386,31 @@ private:
 	CompressedDataColumn(const CompressedDataColumn&);
 	CompressedDataColumn& operator = (const CompressedDataColumn&);
 
+	void page() const {
+		if (pager) {
+			pager->page(pagerIndex);
+		}
+	}
+
 	IntVectorPtr columns;
 	RealVectorPtr data;
 
+	IntVectorPtr secondColumns; // INTERACTION only
+	RealVectorPtr secondData;
+
 	FormatType formatType;
 	mutable std::string stringName;
 	IdType numericalName;
 	bool sharedPtrs; // TODO Actually use shared pointers
+	size_t interactionEntries;
+
+	ColumnPager* pager;
+	int pagerIndex;
+	size_t releasedEntries;
 };
 
+template <typename RealType> class ColumnStore; // forward declaration, see io/ColumnStore.h
+
 template <typename RealType>
 class CompressedDataMatrix {
 
@@ -409,6 +580,45 @@ public:
 		nCols--;
 	}
 
+	// Removes every flagged column in one pass, preserving the order of the rest
+	void erase(const std::vector<bool>& remove) {
+		size_t column = 0;
+		allColumns.erase(std::remove_if(allColumns.begin(), allColumns.end(),
+			[&remove, &column](const typename CompressedDataColumn<RealType>::Ptr&) {
+				return remove[column++];
+			}), allColumns.end());
+		nCols = allColumns.size();
+	}
+
+	// Drops rows mapped to -1 and renumbers the rest, see CompressedDataColumn::compressRows()
+	void compressRows(const std::vector<int>& newRow, size_t nNewRows) {
+		for (auto& column : allColumns) {
+			column->compressRows(newRow);
+		}
+		for (auto& column : allColumns) {
+			if (column->getFormatType() == INTERACTION) {
+				column->countInteractionEntries();
+			}
+		}
+		nRows = nNewRows;
+	}
+
+	// Appends a virtual column holding the product of columns 'first' and 'second'
+	void push_back_interaction(size_t first, size_t second, IdType label) {
+		allColumns.push_back(
+		    make_unique<CompressedDataColumn<RealType>>
+		        (*allColumns[first], *allColumns[second], label)
+		);
+		nCols++;
+	}
+
+	bool hasInteractions() const {
+		return std::any_of(allColumns.begin(), allColumns.end(),
+			[](const typename CompressedDataColumn<RealType>::Ptr& column) {
+				return column->getFormatType() == INTERACTION;
+			});
+	}
+
 	void push_back(IntVectorPtr colIndices, RealVectorPtr colData, FormatType colFormat) {
 	    allColumns.push_back(
 	        make_unique<CompressedDataColumn<RealType>>
@@ -423,6 +633,19 @@ public:
 
 	void printMatrixMarketFormat(std::ostream& stream) const;
 
+	// Moves the column payloads to 'fileName' and pages them back in on access, holding at most
+	// 'cacheBytes' resident and reading 'readAhead' columns ahead of the visiting order.  The
+	// matrix is read-only afterwards; the file is removed with the matrix.
+	void spillToFile(const std::string& fileName, size_t cacheBytes, int readAhead = 2);
+
+	bool isOutOfCore() const {
+		return static_cast<bool>(columnStore);
+	}
+
+	const ColumnStore<RealType>* getColumnStore() const {
+		return columnStore.get();
+	}
+
 protected:
 
     typedef typename CompressedDataColumn<RealType>::Ptr CompressedDataColumnPtr;
@@ -445,6 +668,8 @@ protected:
 
 	DataColumnVector allColumns;
 
+	bsccs::shared_ptr<ColumnStore<RealType>> columnStore; // Destroyed before allColumns
+
 private:
 	// Disable copy-constructors and copy-assignment
 	CompressedDataMatrix(const CompressedDataMatrix&);
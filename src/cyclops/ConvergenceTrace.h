@@ -0,0 +1,90 @@
+/*
+ * ConvergenceTrace.h
+ *
+ * Fixed-capacity ring buffer of per-iteration mode-finding records.  Storage is allocated once
+ * when the trace is enabled; recording never allocates.
+ */
+
+#ifndef CONVERGENCETRACE_H_
+#define CONVERGENCETRACE_H_
+
+#include <vector>
+
+#include "Timing.h"
+
+namespace bsccs {
+
+class ConvergenceTrace {
+public:
+
+	struct Entry {
+		int iteration;
+		double objective;      // log-likelihood + log-prior
+		double criterion;      // value compared against the convergence tolerance
+		double logLikelihood;
+		double logPrior;
+		double maxAbsDelta;    // largest |delta beta| during the cycle
+		int activeSize;        // number of coordinates not held fixed
+		int updateCount;       // number of coordinates that moved during the cycle
+		double seconds;        // wall time since the trace was started
+	};
+
+	ConvergenceTrace() : head(0), size(0) { }
+
+	bool isEnabled() const { return !buffer.empty(); }
+
+	void setCapacity(int capacity) {
+		buffer.assign(capacity > 0 ? capacity : 0, Entry());
+		start();
+	}
+
+	void start() {
+		head = 0;
+		size = 0;
+		startTime = chrono::steady_clock::now();
+	}
+
+	double getElapsedSeconds() const {
+		return chrono::duration_cast<chrono::TimingUnits>(
+			chrono::steady_clock::now() - startTime).count() * 1E-9;
+	}
+
+	void record(const Entry& entry) {
+		buffer[head] = entry;
+		head = (head + 1) % buffer.size();
+		if (size < buffer.size()) {
+			++size;
+		}
+	}
+
+	// Replaces the records with those of a restored solver state
+	void restore(const std::vector<Entry>& entries) {
+		start();
+		if (isEnabled()) {
+			for (const auto& entry : entries) {
+				record(entry);
+			}
+		}
+	}
+
+	// Oldest retained record first
+	std::vector<Entry> getEntries() const {
+		std::vector<Entry> entries;
+		entries.reserve(size);
+		const size_t first = (head + buffer.size() - size) % (buffer.empty() ? 1 : buffer.size());
+		for (size_t i = 0; i < size; ++i) {
+			entries.push_back(buffer[(first + i) % buffer.size()]);
+		}
+		return entries;
+	}
+
+private:
+	std::vector<Entry> buffer;
+	size_t head;
+	size_t size;
+	chrono::steady_clock::time_point startTime;
+};
+
+} // namespace bsccs
+
+#endif /* CONVERGENCETRACE_H_ */
@@ -21,6 +21,7 @@
 #include "CyclicCoordinateDescent.h"
 #include "Iterators.h"
 #include "Timing.h"
+#include "io/BinaryStream.h"
 
 #include "priors/CovariatePrior.h"
 
@@ -53,6 +54,12 @@ CyclicCoordinateDescent::CyclicCoordinateDescent(
 	likelihoodCount = 0;
 	noiseLevel = NOISY;
 	initialBound = 2.0;
+	newtonMaxCovariates = 250;
+	stationaryCycles = 0;
+	scheduleSkipped = false;
+	forceFullSweep = false;
+	shotgunEstimate = 0;
+	shotgunParallelism = 0;
 
 	init(hXI.getHasOffsetCovariate());
 }
@@ -61,6 +68,26 @@ CyclicCoordinateDescent* CyclicCoordinateDescent::clone() {
 	return new (std::nothrow) CyclicCoordinateDescent(*this);
 }
 
+std::vector<CyclicCoordinateDescent*> CyclicCoordinateDescent::cloneForThreads(int nThreads) {
+	std::vector<CyclicCoordinateDescent*> pool(std::max(nThreads, 1), nullptr);
+	pool[0] = this;
+
+	auto makeClone = [this, &pool](size_t i) {
+		if (i > 0) {
+			pool[i] = clone();
+		}
+	};
+
+	if (workerPool) {
+		workerPool->run(pool.size(), pool.size(), makeClone);
+	} else {
+		for (size_t i = 0; i < pool.size(); ++i) {
+			makeClone(i);
+		}
+	}
+	return pool;
+}
+
 //template <typename T>
 //struct GetType<T>;
 
@@ -88,6 +115,14 @@ CyclicCoordinateDescent::CyclicCoordinateDescent(const CyclicCoordinateDescent&
 	likelihoodCount = 0;
 	noiseLevel = copy.noiseLevel;
 	initialBound = copy.initialBound;
+	newtonMaxCovariates = copy.newtonMaxCovariates;
+	stationaryCycles = copy.stationaryCycles;
+	scheduleSkipped = false;
+	forceFullSweep = false;
+	shotgunEstimate = copy.shotgunEstimate; // Same design
+	shotgunParallelism = copy.shotgunEstimate;
+	shotgunFixBeta = copy.shotgunFixBeta;
+	setWorkerPool(copy.workerPool);
 
 	init(hXI.getHasOffsetCovariate());
 
@@ -171,10 +206,111 @@ void CyclicCoordinateDescent::setNoiseLevel(NoiseLevels noise) {
 	noiseLevel = noise;
 }
 
+void CyclicCoordinateDescent::setThreads(int threads) {
+	modelSpecifics.setThreads(getUsableThreads(threads));
+}
+
+int CyclicCoordinateDescent::getUsableThreads(int threads) const {
+	return hXI.getIsOutOfCore() ? 1 : threads; // Evictions would race with other readers
+}
+
+void CyclicCoordinateDescent::setProfiling(bool profiling) {
+	modelSpecifics.getProfiler().setEnabled(profiling);
+}
+
+std::vector<Profiler::Entry> CyclicCoordinateDescent::getProfile() {
+	return modelSpecifics.getProfiler().getEntries();
+}
+
+void CyclicCoordinateDescent::setWorkerPool(WorkerPoolPtr pool) {
+	workerPool = pool;
+	modelSpecifics.setWorkerPool(pool);
+}
+
+void CyclicCoordinateDescent::setConvergenceTrace(int capacity) {
+	convergenceTrace.setCapacity(capacity);
+}
+
+std::vector<ConvergenceTrace::Entry> CyclicCoordinateDescent::getConvergenceTrace() const {
+	return convergenceTrace.getEntries();
+}
+
+namespace {
+const char* STATE_TAG = "CYST";
+const int STATE_VERSION = 2;
+}
+
+void CyclicCoordinateDescent::writeState(std::ostream& stream) {
+
+	// X beta is not stored; rebuilding it from beta costs the same O(nnz) as checking that the
+	// data behind a stored copy are unchanged
+	binary::writeHeader(stream, STATE_TAG, STATE_VERSION);
+	binary::write(stream, static_cast<int>(hXI.getModelType()));
+	binary::write(stream, J);
+	binary::write(stream, hBeta);
+	binary::write(stream, getHyperprior());
+	binary::write(stream, static_cast<int>(lastReturnFlag));
+	binary::write(stream, lastIterationCount);
+	binary::write(stream, convergenceTrace.getEntries());
+	binary::write(stream, crossValidationInfo);
+}
+
+void CyclicCoordinateDescent::readState(std::istream& input) {
+
+	if (!binary::readHeader(input, STATE_TAG, STATE_VERSION)) {
+		std::ostringstream stream;
+		stream << "Not a solver state from this version of Cyclops";
+		error->throwError(stream);
+	}
+
+	int modelType, stateJ, returnFlag, iterationCount;
+	DoubleVector beta, hyperprior;
+	std::vector<ConvergenceTrace::Entry> trace;
+	string info;
+
+	const bool complete = binary::read(input, modelType) && binary::read(input, stateJ) &&
+		binary::read(input, beta) && binary::read(input, hyperprior) &&
+		binary::read(input, returnFlag) &&
+		binary::read(input, iterationCount) && binary::read(input, trace) &&
+		binary::read(input, info);
+
+	if (!complete) {
+		std::ostringstream stream;
+		stream << "Truncated solver state";
+		error->throwError(stream);
+	}
+
+	if (modelType != static_cast<int>(hXI.getModelType()) || stateJ != J ||
+		static_cast<int>(beta.size()) != J || hyperprior.size() != getHyperprior().size()) {
+		std::ostringstream stream;
+		stream << "Solver state does not match this model (" << stateJ << " coefficients and "
+		       << hyperprior.size() << " hyperparameter(s))";
+		error->throwError(stream);
+	}
+
+	setBeta(beta); // X beta follows from the current data
+	for (size_t i = 0; i < hyperprior.size(); ++i) {
+		setHyperprior(i, hyperprior[i]);
+	}
+
+	lastReturnFlag = static_cast<UpdateReturnFlags>(returnFlag);
+	lastIterationCount = iterationCount;
+	convergenceTrace.restore(trace);
+	crossValidationInfo = info;
+}
+
+double CyclicCoordinateDescent::computeDataChecksum(void) const {
+	return hXI.getDataChecksum();
+}
+
 string CyclicCoordinateDescent::getPriorInfo() const {
 	return jointPrior->getDescription();
 }
 
+ModelType CyclicCoordinateDescent::getModelType() const {
+	return hXI.getModelType();
+}
+
 void CyclicCoordinateDescent::setCrossValidationInfo(string info) {
     crossValidationInfo = info;
 }
@@ -187,6 +323,10 @@ void CyclicCoordinateDescent::setPrior(priors::JointPriorPtr newPrior) {
     jointPrior = newPrior;
 }
 
+priors::JointPriorPtr CyclicCoordinateDescent::getPrior() const {
+    return jointPrior;
+}
+
 void CyclicCoordinateDescent::setInitialBound(double bound) {
     initialBound = bound;
 }
@@ -236,6 +376,10 @@ void CyclicCoordinateDescent::init(bool offset) {
 			NULL
 		//	hY
 			);
+
+	if (!hXI.getRowWeight().empty()) {
+		setWeights(NULL); // Compressed copies are always weighted
+	}
 }
 
 int CyclicCoordinateDescent::getAlignedLength(int N) {
@@ -247,6 +391,18 @@ void CyclicCoordinateDescent::computeNEvents() {
 	//	hWeights.size() > 0 ? hWeights.data() : nullptr,
 	//	useCrossValidation);
 	// ESK: My version to incorporate censor weights as well
+	const auto& multiplicity = hXI.getRowWeight();
+	if (!multiplicity.empty()) {
+		std::vector<double> weights(K);
+		for (int k = 0; k < K; ++k) {
+			weights[k] = hWeights[k] * multiplicity[k];
+		}
+		modelSpecifics.setWeights(
+		    weights.data(),
+		    cWeights.size() > 0 ? cWeights.data() : nullptr,
+		    useCrossValidation);
+		return;
+	}
 	modelSpecifics.setWeights(
 	    hWeights.size() > 0 ? hWeights.data() : nullptr,
 	    cWeights.size() > 0 ? cWeights.data() : nullptr,
@@ -261,6 +417,7 @@ void CyclicCoordinateDescent::resetBeta(void) {
 	}
 	computeXBeta();
 	sufficientStatisticsKnown = false;
+	shotgunParallelism = shotgunEstimate; // Back-offs belong to the previous fit
 }
 
 void CyclicCoordinateDescent::logResults(const char* fileName, bool withASE) {
@@ -351,6 +508,15 @@ double CyclicCoordinateDescent::getNewPredictiveLogLikelihood(double* weights) {
 
     getDenominators();
 
+    const auto& multiplicity = hXI.getRowWeight();
+    if (!multiplicity.empty()) {
+        std::vector<double> scaled(weights, weights + K);
+        for (int k = 0; k < K; ++k) {
+            scaled[k] *= multiplicity[k];
+        }
+        return modelSpecifics.getPredictiveLogLikelihood(scaled.data());
+    }
+
     return modelSpecifics.getPredictiveLogLikelihood(weights); // TODO Pass double
 }
 
@@ -358,6 +524,18 @@ void CyclicCoordinateDescent::getPredictiveEstimates(double* y, double* weights)
 	modelSpecifics.getPredictiveEstimates(y, weights);
 }
 
+void CyclicCoordinateDescent::getBaselineHazard(std::vector<double>& time,
+                                                std::vector<double>& hazard,
+                                                std::vector<int>& stratum) {
+	checkAllLazyFlags();
+
+	if (!modelSpecifics.getBaselineHazard(time, hazard, stratum)) {
+	    std::ostringstream stream;
+	    stream << "Baseline hazard is only available for survival models";
+	    error->throwError(stream);
+	}
+}
+
 int CyclicCoordinateDescent::getBetaSize(void) {
 	return J;
 }
@@ -412,7 +590,50 @@ double CyclicCoordinateDescent::getLogLikelihood(void) {
 	getDenominators();
 	likelihoodCount += 1;
 
-	return modelSpecifics.getLogLikelihood(useCrossValidation);
+	double logLikelihood = modelSpecifics.getLogLikelihood(useCrossValidation);
+
+	const auto& shift = hXI.getRowLogLikelihoodShift(); // Constants of summed rows
+	for (size_t k = 0; k < shift.size(); ++k) {
+		logLikelihood += useCrossValidation ? hWeights[k] * shift[k] : shift[k];
+	}
+	return logLikelihood;
+}
+
+double CyclicCoordinateDescent::getLogLikelihoodGradient(std::vector<double>& gradient) {
+
+	const double logLikelihood = getLogLikelihood(); // Leaves the sufficient statistics current
+
+	// Engine gradients are of the negative log-likelihood
+	modelSpecifics.computeGradient(gradient, std::vector<bool>(J, false), useCrossValidation);
+	for (auto& element : gradient) {
+		element = -element;
+	}
+	return logLikelihood;
+}
+
+void CyclicCoordinateDescent::getLogLikelihoodHessianVectorProduct(const std::vector<double>& vector,
+                                                                   std::vector<double>& product) {
+
+	const ModelType modelType = hXI.getModelType();
+	if (modelType != ModelType::NORMAL && modelType != ModelType::POISSON &&
+		modelType != ModelType::LOGISTIC) {
+		std::ostringstream stream;
+		stream << "Hessian-vector products are only available for models with independent rows";
+		error->throwError(stream);
+	}
+	if (static_cast<int>(vector.size()) != J) {
+		std::ostringstream stream;
+		stream << "Vector length (" << vector.size() << ") does not match the number of coefficients (" << J << ")";
+		error->throwError(stream);
+	}
+
+	checkAllLazyFlags();
+	modelSpecifics.computeHessianVectorProduct(vector, product, useCrossValidation);
+	if (modelType == ModelType::NORMAL) { // -sum(r^2) has curvature 2 X'X; its Fisher information is X'X
+		for (auto& element : product) {
+			element *= 2.0;
+		}
+	}
 }
 
 void CyclicCoordinateDescent::getDenominators() {
@@ -451,6 +672,60 @@ void CyclicCoordinateDescent::makeDirty(void) {
 	sufficientStatisticsKnown = false;
 }
 
+bool CyclicCoordinateDescent::updateForAppendedData(void) {
+	const int newK = hXI.getNumberOfRows();
+	const int newJ = hXI.getNumberOfCovariates();
+
+	if (newK == K && newJ == J) {
+		return false;
+	}
+
+	if (newK < K || newJ < J) {
+		std::ostringstream stream;
+		stream << "Data have fewer rows or covariates than the fitted model; build a new model";
+		error->throwError(stream);
+	}
+
+	if (!hXI.getRowMultiplicity().empty()) {
+		std::ostringstream stream;
+		stream << "Cannot append rows to compressed data";
+		error->throwError(stream);
+	}
+
+	const int oldK = K;
+	const bool incremental = xBetaKnown && validWeights && sufficientStatisticsKnown &&
+		!useCrossValidation && cWeights.empty();
+
+	N = hXI.getNumberOfPatients();
+	K = newK;
+	J = newJ;
+
+	hDelta.resize(J, initialBound);
+	hBeta.resize(J, 0.0);
+	fixBeta.resize(J, false);
+	if (!hWeights.empty()) {
+		hWeights.resize(K, 1.0);
+	}
+	if (!cWeights.empty()) {
+		cWeights.resize(K, 1.0);
+	}
+
+	const bool inPlace = modelSpecifics.appendRows(N, K, J, hBeta.data(), incremental);
+	if (!inPlace) {
+		makeDirty();
+	}
+	fisherInformationKnown = false;
+	varianceKnown = false;
+
+	if (noiseLevel > QUIET) {
+		std::ostringstream stream;
+		stream << "Appended " << (K - oldK) << " rows; "
+			   << (inPlace ? "updated statistics in place" : "recomputing all statistics");
+		logger->writeLine(stream);
+	}
+	return inPlace;
+}
+
 void CyclicCoordinateDescent::setPriorType(int iPriorType) {
 	if (iPriorType < priors::NONE || iPriorType > priors::NORMAL) {
 	    std::ostringstream stream;
@@ -495,7 +770,14 @@ std::vector<double> CyclicCoordinateDescent::getCensorWeights() {
 
 void CyclicCoordinateDescent::setWeights(double* iWeights) {
 
-	if (iWeights == NULL) {
+	if (iWeights == NULL && !hXI.getRowWeight().empty()) {
+		// Row multiplicities are applied in computeNEvents(); the fit stays weighted, which
+		// also keeps it on coordinate-wise (non-Newton) updates
+		hWeights.assign(K, 1.0);
+		useCrossValidation = true;
+		validWeights = false;
+		sufficientStatisticsKnown = false;
+	} else if (iWeights == NULL) {
 		if (hWeights.size() != 0) {
 			hWeights.resize(0);
 		}
@@ -565,9 +847,11 @@ double CyclicCoordinateDescent::computeZhangOlesConvergenceCriterion(void) {
 	auto& hXBetaSave = modelSpecifics.getXBetaSave();
 
 	if (useCrossValidation) {
+		const auto& multiplicity = hXI.getRowWeight();
 		for (int i = 0; i < K; i++) {
-			sumAbsDiffs += abs(hXBeta[i] - hXBetaSave[i]) * hWeights[i];
-			sumAbsResiduals += abs(hXBeta[i]) * hWeights[i];
+			const double weight = multiplicity.empty() ? hWeights[i] : hWeights[i] * multiplicity[i];
+			sumAbsDiffs += abs(hXBeta[i] - hXBetaSave[i]) * weight;
+			sumAbsResiduals += abs(hXBeta[i]) * weight;
 		}
 	} else {
 		for (int i = 0; i < K; i++) {
@@ -593,6 +877,14 @@ void CyclicCoordinateDescent::update(const ModeFindingArguments& arguments) {
 	const int qnQ = 0;
 
 	initialBound = arguments.initialBound;
+	newtonMaxCovariates = arguments.newtonMaxCovariates;
+	stationaryCycles = arguments.stationaryCycles;
+
+	updateForAppendedData();
+
+	if (convergenceTrace.isEnabled()) {
+		convergenceTrace.start();
+	}
 
 	int count = 0;
 	bool done = false;
@@ -663,6 +955,8 @@ void CyclicCoordinateDescent::kktSwindle(const ModeFindingArguments& arguments)
                 !jointPrior->getSupportsKktSwindle(index)) {
 // 				activeSet.push_back(index);
 				activeSet.push_back(std::make_tuple(index, 0.0, true));
+			} else if (hBeta[index] != 0.0) { // Warm starts keep their active set
+				activeSet.push_back(std::make_tuple(index, 0.0, false));
 			} else {
 				inactiveSet.push_back(std::make_tuple(index, 0.0, false));
 			}
@@ -677,6 +971,8 @@ void CyclicCoordinateDescent::kktSwindle(const ModeFindingArguments& arguments)
 
 	while (!done) {
 
+		ScopedTimer roundTimer(modelSpecifics.getProfiler(), ProfilePhase::KKT_ROUND);
+
 		if (noiseLevel >= QUIET) {
 			std::ostringstream stream;
 			stream << "\nKKT Swindle count " << swindleIterationCount << ", activeSet size =  " << activeSet.size();
@@ -816,6 +1112,8 @@ void CyclicCoordinateDescent::kktSwindle(const ModeFindingArguments& arguments)
 template <typename Container>
 void CyclicCoordinateDescent::computeKktConditions(Container& scoreSet) {
 
+    ScopedTimer timer(modelSpecifics.getProfiler(), ProfilePhase::KKT_CHECK);
+
     for (auto& score : scoreSet) {
         const auto index = std::get<0>(score);
 
@@ -869,6 +1167,15 @@ bool CyclicCoordinateDescent::performCheckConvergence(int convergenceType,
     double thisLogPrior = getLogPrior();
     double thisLogPost = thisLogLikelihood + thisLogPrior;
 
+    if (convergenceTrace.isEnabled()) {
+        const int activeSize = std::count(fixBeta.begin(), fixBeta.end(), false);
+        convergenceTrace.record(ConvergenceTrace::Entry{
+            iteration, thisLogPost, conv, thisLogLikelihood, thisLogPrior,
+            cycleMaxAbsDelta, activeSize, cycleUpdateCount,
+            convergenceTrace.getElapsedSeconds()
+        });
+    }
+
     std::ostringstream stream;
     if (noiseLevel > QUIET) {
         // stream << "\n";
@@ -944,6 +1251,8 @@ void CyclicCoordinateDescent::findMode(
 
 	bool done = false;
 	int iteration = 0;
+	cycleMaxAbsDelta = 0.0;
+	cycleUpdateCount = 0;
 	double lastObjFunc = 0.0;
 
 	if (convergenceType < ZHANG_OLES) {
@@ -961,7 +1270,55 @@ void CyclicCoordinateDescent::findMode(
 	    lastLogPosterior = -10E10;
 	}
 
-	auto cycle = [this,&iteration,algorithmType,&allDelta] {
+	bool useNewton = false;
+	if (algorithmType == AlgorithmType::NEWTON) {
+	    useNewton = getCanUseNewton();
+	    if (!useNewton && noiseLevel > SILENT) {
+	        std::ostringstream stream;
+	        stream << "Newton steps are not available for this prior, weighting or number of covariates; "
+	               << "using cyclic coordinate descent";
+	        logger->writeLine(stream);
+	    }
+	}
+
+	scheduleSkipped = false;
+	forceFullSweep = false;
+	if (stationaryCycles > 0) {
+	    zeroCycleCount.assign(J, 0);
+	}
+
+	bool useShotgun = false;
+	if (algorithmType == AlgorithmType::SHOTGUN) {
+	    useShotgun = getShotgunParallelism() > 1;
+	    if (noiseLevel > SILENT) {
+	        std::ostringstream stream;
+	        if (useShotgun) {
+	            stream << "Updating up to " << shotgunParallelism << " coordinates at a time";
+	        } else {
+	            stream << "Parallel coordinate updates are not available for this model or design; "
+	                   << "using cyclic coordinate descent";
+	        }
+	        logger->writeLine(stream);
+	    }
+	}
+
+	bool useLbfgs = false;
+	if (algorithmType == AlgorithmType::LBFGS) {
+	    useLbfgs = getCanUseLbfgs();
+	    lbfgsS.clear();
+	    lbfgsY.clear();
+	    lbfgsLastBeta.clear();
+	    if (!useLbfgs && noiseLevel > SILENT) {
+	        std::ostringstream stream;
+	        stream << "L-BFGS steps are not available for this prior; using cyclic coordinate descent";
+	        logger->writeLine(stream);
+	    }
+	}
+
+	auto cycle = [this,&iteration,algorithmType,&allDelta,useNewton,useLbfgs,useShotgun] {
+
+	    cycleMaxAbsDelta = 0.0;
+	    cycleUpdateCount = 0;
 
 	    auto log = [this](const int index) {
 	        if ( (noiseLevel > QUIET) && ((index+1) % 100 == 0)) {
@@ -988,6 +1345,8 @@ void CyclicCoordinateDescent::findMode(
                     if (delta != 0.0) {
                         sufficientStatisticsKnown = false;
                         hBeta[index] += delta;
+                        cycleMaxAbsDelta = std::max(cycleMaxAbsDelta, std::abs(delta));
+                        ++cycleUpdateCount;
 
                         // std::cerr << " : " << index << " " << hBeta[index] << " " << delta;
 
@@ -1003,6 +1362,22 @@ void CyclicCoordinateDescent::findMode(
             sufficientStatisticsKnown = true;
 
 
+	    } else if (useNewton && newtonUpdateAllBeta()) {
+
+	        // Full Newton step accepted by the line search
+
+	    } else if (useLbfgs && lbfgsUpdateAllBeta()) {
+
+	        // Quasi-Newton step accepted by the line search
+
+	    } else if (useShotgun && shotgunParallelism > 1) {
+
+	        shotgunUpdateAllBeta();
+
+	    } else if (stationaryCycles > 0) {
+
+	        scheduledUpdateAllBeta(iteration);
+
 	    } else {
 
 	        // Do a complete cycle in serial
@@ -1014,6 +1389,8 @@ void CyclicCoordinateDescent::findMode(
 	                if (delta != 0.0) {
 	                    sufficientStatisticsKnown = false;
 	                    updateSufficientStatistics(delta, index);
+	                    cycleMaxAbsDelta = std::max(cycleMaxAbsDelta, std::abs(delta));
+	                    ++cycleUpdateCount;
 	                }
 	            }
 
@@ -1203,6 +1580,10 @@ void CyclicCoordinateDescent::findMode(
         while (!done) {
             cycle();
             done = check();
+            if (done && scheduleSkipped && lastReturnFlag == SUCCESS) {
+                done = false; // Confirm with every coordinate before stopping
+                forceFullSweep = true;
+            }
         }
     }
 
@@ -1390,6 +1771,406 @@ void CyclicCoordinateDescent::mmUpdateAllBeta(std::vector<double>& delta,
     }
 }
 
+bool CyclicCoordinateDescent::getCanUseNewton(void) const {
+    if (useCrossValidation) {
+        return false; // Newton steps are not yet used with cross-validation weights
+    }
+    const ModelType modelType = hXI.getModelType();
+    if (modelType != ModelType::NORMAL && modelType != ModelType::POISSON &&
+        modelType != ModelType::LOGISTIC && modelType != ModelType::SELF_CONTROLLED_MODEL &&
+        modelType != ModelType::CONDITIONAL_LOGISTIC && modelType != ModelType::CONDITIONAL_POISSON) {
+        return false; // Risk-set and exact-conditional Hessians do not decompose by row or stratum
+    }
+    int nFree = 0;
+    priors::GradientHessian gh;
+    for (int j = 0; j < J; ++j) {
+        if (!fixBeta[j]) {
+            ++nFree;
+            if (!jointPrior->getGradientHessian(hBeta, j, gh)) {
+                return false;
+            }
+        }
+    }
+    return nFree > 0 && nFree <= newtonMaxCovariates;
+}
+
+bool CyclicCoordinateDescent::newtonUpdateAllBeta(void) {
+
+    if (!sufficientStatisticsKnown) {
+        std::ostringstream stream;
+        stream << "Error in state synchronization.";
+        error->throwError(stream);
+    }
+
+    std::vector<int> active;
+    for (int j = 0; j < J; ++j) {
+        if (!fixBeta[j]) {
+            active.push_back(j);
+        }
+    }
+    const int n = active.size();
+
+    // Gradient and Hessian of the negative log posterior over the free coefficients;
+    // the likelihood Hessian comes from a single sweep over the rows of X
+    std::vector<double> information;
+    if (!modelSpecifics.computeFisherInformationMatrix(active, information, useCrossValidation)) {
+        return false;
+    }
+    std::vector<double> allGradient;
+    modelSpecifics.computeGradient(allGradient, fixBeta, useCrossValidation);
+
+    // -sum(r^2) has curvature 2 X'X, while its Fisher information is kept at X'X
+    const double scale = (hXI.getModelType() == ModelType::NORMAL) ? 2.0 : 1.0;
+
+    Eigen::VectorXd gradient(n);
+    Matrix hessian = scale * Eigen::Map<Matrix>(information.data(), n, n);
+    for (int a = 0; a < n; ++a) {
+        const int j = active[a];
+        priors::GradientHessian prior;
+        jointPrior->getGradientHessian(hBeta, j, prior);
+        gradient(a) = allGradient[j] + prior.first;
+        hessian(a, a) += prior.second;
+    }
+
+    Eigen::LDLT<Matrix> ldlt(hessian);
+    if (ldlt.info() != Eigen::Success || !ldlt.isPositive()) {
+        return false;
+    }
+    const Eigen::VectorXd direction = -ldlt.solve(gradient);
+    if (!std::isfinite(direction.squaredNorm())) {
+        return false;
+    }
+
+    // Step-halving on the log posterior; each trial recomputes xBeta from beta, because
+    // incremental updates do not recover from an overflowing trial step
+    const DoubleVector startBeta(hBeta);
+    const double startObjective = getLogLikelihood() + getLogPrior();
+    double step = 1.0;
+    const int maxHalvings = 20;
+    const double slack = 1E-12 * std::abs(startObjective); // Rounding noise near the mode
+    for (int halving = 0; halving <= maxHalvings; ++halving, step *= 0.5) {
+        for (int a = 0; a < n; ++a) {
+            hBeta[active[a]] = startBeta[active[a]] + step * direction(a);
+        }
+        xBetaKnown = false;
+        sufficientStatisticsKnown = false;
+        checkAllLazyFlags();
+        if (getLogLikelihood() + getLogPrior() >= startObjective - slack) {
+            cycleMaxAbsDelta = step * direction.cwiseAbs().maxCoeff();
+            cycleUpdateCount = (direction.array() != 0.0).count();
+            return true;
+        }
+    }
+
+    hBeta = startBeta; // Restore
+    xBetaKnown = false;
+    sufficientStatisticsKnown = false;
+    checkAllLazyFlags();
+    return false;
+}
+
+bool CyclicCoordinateDescent::getCanUseLbfgs(void) const {
+    int nFree = 0;
+    priors::GradientHessian gh;
+    double lambda;
+    for (int j = 0; j < J; ++j) {
+        if (!fixBeta[j]) {
+            ++nFree;
+            if (!jointPrior->getGradientHessian(hBeta, j, gh) &&
+                !jointPrior->getL1Penalty(j, lambda)) {
+                return false;
+            }
+        }
+    }
+    return nFree > 0;
+}
+
+bool CyclicCoordinateDescent::lbfgsUpdateAllBeta(void) {
+
+    if (!sufficientStatisticsKnown) {
+        std::ostringstream stream;
+        stream << "Error in state synchronization.";
+        error->throwError(stream);
+    }
+
+    std::vector<int> active;
+    for (int j = 0; j < J; ++j) {
+        if (!fixBeta[j]) {
+            active.push_back(j);
+        }
+    }
+    const int n = active.size();
+    const int memory = 10;
+
+    // Smooth part of the negative log posterior gradient, all columns in one sweep
+    std::vector<double> allGradient;
+    modelSpecifics.computeGradient(allGradient, fixBeta, useCrossValidation);
+
+    std::vector<double> beta(n), gradient(n), lambda(n, 0.0), pseudo(n);
+    for (int a = 0; a < n; ++a) {
+        const int j = active[a];
+        priors::GradientHessian prior(0.0, 0.0);
+        if (!jointPrior->getGradientHessian(hBeta, j, prior)) {
+            jointPrior->getL1Penalty(j, lambda[a]);
+        }
+        beta[a] = hBeta[j];
+        gradient[a] = allGradient[j] + prior.first;
+
+        // OWL-QN pseudo-gradient: one-sided derivative in the descent direction
+        if (beta[a] > 0.0) {
+            pseudo[a] = gradient[a] + lambda[a];
+        } else if (beta[a] < 0.0) {
+            pseudo[a] = gradient[a] - lambda[a];
+        } else if (gradient[a] + lambda[a] < 0.0) {
+            pseudo[a] = gradient[a] + lambda[a];
+        } else if (gradient[a] - lambda[a] > 0.0) {
+            pseudo[a] = gradient[a] - lambda[a];
+        } else {
+            pseudo[a] = 0.0;
+        }
+    }
+
+    if (!lbfgsLastBeta.empty()) {
+        std::vector<double> s(n), y(n);
+        double sy = 0.0;
+        for (int a = 0; a < n; ++a) {
+            s[a] = beta[a] - lbfgsLastBeta[a];
+            y[a] = gradient[a] - lbfgsLastGradient[a];
+            sy += s[a] * y[a];
+        }
+        if (sy > 0.0) { // Keep the inverse Hessian approximation positive definite
+            lbfgsS.push_back(std::move(s));
+            lbfgsY.push_back(std::move(y));
+            if (static_cast<int>(lbfgsS.size()) > memory) {
+                lbfgsS.pop_front();
+                lbfgsY.pop_front();
+            }
+        }
+    }
+
+    auto dot = [n](const std::vector<double>& lhs, const std::vector<double>& rhs) {
+        double sum = 0.0;
+        for (int a = 0; a < n; ++a) {
+            sum += lhs[a] * rhs[a];
+        }
+        return sum;
+    };
+
+    const double pseudoNorm = std::sqrt(dot(pseudo, pseudo));
+    if (pseudoNorm == 0.0) {
+        cycleMaxAbsDelta = 0.0;
+        cycleUpdateCount = 0;
+        return true; // At the mode
+    }
+
+    // Two-loop recursion for direction = -H * pseudo
+    std::vector<double> direction(pseudo);
+    const int m = lbfgsS.size();
+    std::vector<double> alpha(m);
+    for (int i = m - 1; i >= 0; --i) {
+        alpha[i] = dot(lbfgsS[i], direction) / dot(lbfgsS[i], lbfgsY[i]);
+        for (int a = 0; a < n; ++a) {
+            direction[a] -= alpha[i] * lbfgsY[i][a];
+        }
+    }
+    const double scale = (m > 0) ?
+        dot(lbfgsS[m - 1], lbfgsY[m - 1]) / dot(lbfgsY[m - 1], lbfgsY[m - 1]) :
+        1.0 / pseudoNorm;
+    for (int a = 0; a < n; ++a) {
+        direction[a] *= scale;
+    }
+    for (int i = 0; i < m; ++i) {
+        const double b = dot(lbfgsY[i], direction) / dot(lbfgsS[i], lbfgsY[i]);
+        for (int a = 0; a < n; ++a) {
+            direction[a] += (alpha[i] - b) * lbfgsS[i][a];
+        }
+    }
+    for (int a = 0; a < n; ++a) {
+        direction[a] = -direction[a];
+        if (direction[a] * pseudo[a] >= 0.0) {
+            direction[a] = 0.0; // Restrict to the orthant-wise descent directions
+        }
+    }
+
+    // Backtracking on the log posterior, projecting each trial point onto the current orthant
+    const double startObjective = getLogLikelihood() + getLogPrior();
+    const double slack = 1E-12 * std::abs(startObjective); // Rounding noise near the mode
+    std::vector<double> current(beta);
+    const int maxHalvings = 20;
+    double step = 1.0;
+    for (int halving = 0; halving <= maxHalvings; ++halving, step *= 0.5) {
+        double directional = 0.0;
+        for (int a = 0; a < n; ++a) {
+            double trial = beta[a] + step * direction[a];
+            if (lambda[a] > 0.0) {
+                const double orthant = (beta[a] != 0.0) ? beta[a] : -pseudo[a];
+                if (trial * orthant <= 0.0) {
+                    trial = 0.0;
+                }
+            }
+            const double delta = trial - current[a];
+            if (delta != 0.0) {
+                updateSufficientStatistics(delta, active[a]);
+                current[a] = trial;
+            }
+            directional += pseudo[a] * (trial - beta[a]);
+        }
+        if (getLogLikelihood() + getLogPrior() >= startObjective - 1E-4 * directional - slack) {
+            cycleMaxAbsDelta = 0.0;
+            cycleUpdateCount = 0;
+            for (int a = 0; a < n; ++a) {
+                const double delta = std::abs(current[a] - beta[a]);
+                if (delta > 0.0) {
+                    cycleMaxAbsDelta = std::max(cycleMaxAbsDelta, delta);
+                    ++cycleUpdateCount;
+                }
+            }
+            lbfgsLastBeta = std::move(beta);
+            lbfgsLastGradient = std::move(gradient);
+            return true;
+        }
+    }
+
+    for (int a = 0; a < n; ++a) { // Restore
+        const double delta = beta[a] - current[a];
+        if (delta != 0.0) {
+            updateSufficientStatistics(delta, active[a]);
+        }
+    }
+    lbfgsS.clear(); // A coordinate descent cycle follows; restart the secant history
+    lbfgsY.clear();
+    lbfgsLastBeta.clear();
+    return false;
+}
+
+int CyclicCoordinateDescent::getShotgunParallelism(void) {
+    const ModelType modelType = hXI.getModelType();
+    if (modelType != ModelType::NORMAL && modelType != ModelType::POISSON &&
+        modelType != ModelType::LOGISTIC) {
+        return 0; // Column kernels share scratch space across rows of a stratum
+    }
+    if (shotgunEstimate == 0 || shotgunFixBeta != fixBeta) {
+        // Shotgun (Bradley et al., 2011): about nFree / rho coordinates can be updated together,
+        // where rho is the spectral radius of the normalized Gram matrix
+        const int nFree = std::count(fixBeta.begin(), fixBeta.end(), false);
+        const double rho = modelSpecifics.estimateSpectralRadius(fixBeta, 20);
+        shotgunEstimate = (rho > 0.0) ?
+            std::max(1, std::min(nFree, static_cast<int>(nFree / rho))) : 1;
+        shotgunFixBeta = fixBeta;
+    }
+    shotgunParallelism = shotgunEstimate; // Each fit starts without back-offs
+    return shotgunParallelism;
+}
+
+void CyclicCoordinateDescent::shotgunUpdateAllBeta(void) {
+
+    std::vector<int> active;
+    for (int j = 0; j < J; ++j) {
+        if (!fixBeta[j]) {
+            active.push_back(j);
+        }
+    }
+    const int n = active.size();
+
+    const double startObjective = getLogLikelihood() + getLogPrior();
+    const DoubleVector startBeta(hBeta);
+    const double startMaxAbsDelta = cycleMaxAbsDelta;
+    const int startUpdateCount = cycleUpdateCount;
+
+    std::vector<int> block;
+    std::vector<priors::GradientHessian> gh;
+    std::vector<double> delta;
+    for (;;) {
+        const int nBlocks = (n + shotgunParallelism - 1) / shotgunParallelism;
+        for (int b = 0; b < nBlocks; ++b) {
+
+            if (!sufficientStatisticsKnown) {
+                std::ostringstream stream;
+                stream << "Error in state synchronization.";
+                error->throwError(stream);
+            }
+
+            block.clear();
+            for (int a = b; a < n; a += nBlocks) { // Interleave so adjacent (often related) columns split up
+                block.push_back(active[a]);
+            }
+
+            // All deltas in a block come from the same xBeta
+            modelSpecifics.computeGradientAndHessianBatch(block, gh, useCrossValidation);
+
+            delta.resize(block.size());
+            for (int i = 0; i < static_cast<int>(block.size()); ++i) {
+                if (gh[i].second < 0.0) {
+                    gh[i].first = 0.0;
+                    gh[i].second = 0.0;
+                }
+                delta[i] = applyBounds(jointPrior->getDelta(gh[i], hBeta, block[i]), block[i]);
+            }
+
+            for (int i = 0; i < static_cast<int>(block.size()); ++i) {
+                if (delta[i] != 0.0) {
+                    sufficientStatisticsKnown = false;
+                    updateSufficientStatistics(delta[i], block[i]);
+                    cycleMaxAbsDelta = std::max(cycleMaxAbsDelta, std::abs(delta[i]));
+                    ++cycleUpdateCount;
+                }
+            }
+        }
+
+        if (shotgunParallelism == 1 ||
+                getLogLikelihood() + getLogPrior() >= startObjective - 1E-12 * std::abs(startObjective)) {
+            return;
+        }
+
+        // Updates interfered; undo the cycle and repeat it with smaller blocks
+        hBeta = startBeta;
+        xBetaKnown = false;
+        sufficientStatisticsKnown = false;
+        checkAllLazyFlags();
+        cycleMaxAbsDelta = startMaxAbsDelta;
+        cycleUpdateCount = startUpdateCount;
+
+        shotgunParallelism = std::max(1, shotgunParallelism / 2);
+        if (noiseLevel > QUIET) {
+            std::ostringstream stream;
+            stream << "Log posterior decreased; updating up to " << shotgunParallelism
+                   << " coordinates at a time";
+            logger->writeLine(stream);
+        }
+    }
+}
+
+void CyclicCoordinateDescent::scheduledUpdateAllBeta(int iteration) {
+
+    // Coordinates at zero for stationaryCycles cycles sit out, except on every
+    // stationaryCycles-th cycle and on the confirming sweep at convergence
+    const bool fullSweep = forceFullSweep || (iteration % stationaryCycles == 0);
+    forceFullSweep = false;
+
+    schedule.clear();
+    int nFree = 0;
+    for (int j = 0; j < J; ++j) {
+        if (!fixBeta[j]) {
+            ++nFree;
+            if (fullSweep || zeroCycleCount[j] < stationaryCycles) {
+                schedule.push_back(j);
+            }
+        }
+    }
+    scheduleSkipped = static_cast<int>(schedule.size()) < nFree;
+
+    for (int index : schedule) {
+        double delta = ccdUpdateBeta(index);
+        delta = applyBounds(delta, index);
+        if (delta != 0.0) {
+            sufficientStatisticsKnown = false;
+            updateSufficientStatistics(delta, index);
+            cycleMaxAbsDelta = std::max(cycleMaxAbsDelta, std::abs(delta));
+            ++cycleUpdateCount;
+        }
+        zeroCycleCount[index] = (delta == 0.0 && hBeta[index] == 0.0) ? zeroCycleCount[index] + 1 : 0;
+    }
+}
 
 double CyclicCoordinateDescent::ccdUpdateBeta(int index) {
 
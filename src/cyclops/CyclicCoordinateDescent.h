@@ -12,6 +12,7 @@
 #include "CompressedDataMatrix.h"
 #include "ModelData.h"
 #include "engine/AbstractModelSpecifics.h"
+#include "ConvergenceTrace.h"
 #include "priors/JointPrior.h"
 #include "io/ProgressLogger.h"
 
@@ -67,18 +68,33 @@ public:
 
 	CyclicCoordinateDescent* clone();
 
+	// Returns this object followed by nThreads - 1 clones.  Clone i is built on the worker-pool
+	// thread that runs chunk i of a TaskScheduler, so its buffers are first touched (and placed)
+	// on that thread's NUMA node.
+	std::vector<CyclicCoordinateDescent*> cloneForThreads(int nThreads);
+
 	void logResults(const char* fileName, bool withASE);
 
 	virtual ~CyclicCoordinateDescent();
 
 	double getLogLikelihood(void);
 
+	// Log-likelihood and its gradient with respect to every coefficient
+	double getLogLikelihoodGradient(std::vector<double>& gradient);
+
+	// Log-likelihood Hessian times a vector; independent-row models only
+	void getLogLikelihoodHessianVectorProduct(const std::vector<double>& vector,
+                                              std::vector<double>& product);
+
 	//double getPredictiveLogLikelihood(double* weights);
 
 	double getNewPredictiveLogLikelihood(double* weights);
 
 	void getPredictiveEstimates(double* y, double* weights) const;
 
+	void getBaselineHazard(std::vector<double>& time, std::vector<double>& hazard,
+                           std::vector<int>& stratum);
+
 	double getLogPrior(void);
 
 	virtual double getObjectiveFunction(int convergenceType);
@@ -110,6 +126,8 @@ public:
 	// Setters
 	void setPrior(priors::JointPriorPtr newPrior);
 
+	priors::JointPriorPtr getPrior() const;
+
 	void setHyperprior(double value); // TODO depricate
 
 	void setHyperprior(int index, double value);
@@ -141,6 +159,11 @@ public:
 
 	string getPriorInfo() const;
 
+	ModelType getModelType() const;
+
+	// Fingerprint of the outcomes and design matrix entries
+	double computeDataChecksum(void) const;
+
 	string getCrossValidationInfo() const;
 
 	void setCrossValidationInfo(string info);
@@ -167,8 +190,36 @@ public:
 
 	void setNoiseLevel(NoiseLevels);
 
+	void setThreads(int threads);
+
+	// Threads that may work on this data at once; one when its columns are paged from a file
+	int getUsableThreads(int threads) const;
+
+	void setProfiling(bool profiling);
+
+	std::vector<Profiler::Entry> getProfile();
+
+	void setConvergenceTrace(int capacity);
+
+	void setWorkerPool(WorkerPoolPtr pool);
+
+	WorkerPool* getWorkerPool() const { return workerPool.get(); }
+
+	std::vector<ConvergenceTrace::Entry> getConvergenceTrace() const;
+
+	// Compact binary snapshot of coefficients, hyperparameters, convergence history and
+	// cross-validation result; restoring it warm-starts the next fit
+	void writeState(std::ostream& stream);
+
+	void readState(std::istream& input);
+
 	void makeDirty(void);
 
+	// Picks up rows and covariates appended to the data since the last fit, keeping the current
+	// coefficients as a warm start; new coefficients start at zero.  Returns true when the cached
+	// statistics were updated for the appended entries only.
+	bool updateForAppendedData(void);
+
 	void setInitialBound(double bound);
 
 	Matrix computeFisherInformation(const std::vector<size_t>& indices) const;
@@ -269,6 +320,20 @@ protected:
 	void mmUpdateAllBeta(std::vector<double>& allDelta,
                          const std::vector<bool>& fixedBeta);
 
+	bool getCanUseNewton(void) const;
+
+	bool newtonUpdateAllBeta(void);
+
+	bool getCanUseLbfgs(void) const;
+
+	bool lbfgsUpdateAllBeta(void);
+
+	int getShotgunParallelism(void);
+
+	void shotgunUpdateAllBeta(void);
+
+	void scheduledUpdateAllBeta(int iteration);
+
 
 	double applyBounds(
 			double inDelta,
@@ -344,6 +409,22 @@ protected:
 	int priorType;
 
 	double initialBound;
+	int newtonMaxCovariates;
+
+	std::deque<std::vector<double>> lbfgsS; // Most recent steps and gradient changes over the free coefficients
+	std::deque<std::vector<double>> lbfgsY;
+	std::vector<double> lbfgsLastBeta;
+	std::vector<double> lbfgsLastGradient;
+
+	int stationaryCycles; // Skip coordinates held at zero this many cycles; 0 visits all in order
+	std::vector<int> zeroCycleCount;
+	std::vector<int> schedule;
+	bool scheduleSkipped;
+	bool forceFullSweep;
+
+	int shotgunEstimate; // Coordinates that can be updated together; cached for shotgunFixBeta
+	int shotgunParallelism; // Coordinates updated together in this fit, backed off on failure
+	std::vector<bool> shotgunFixBeta;
 
 	bool sufficientStatisticsKnown;
 	bool xBetaKnown;
@@ -362,6 +443,12 @@ protected:
 	UpdateReturnFlags lastReturnFlag;
 	int lastIterationCount;
 
+	ConvergenceTrace convergenceTrace;
+
+	WorkerPoolPtr workerPool;
+	double cycleMaxAbsDelta;
+	int cycleUpdateCount;
+
 	Matrix hessianMatrix;
 	Matrix varianceMatrix;
 
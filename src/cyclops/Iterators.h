@@ -19,6 +19,7 @@ struct IndicatorTag {};
 struct SparseTag {};
 struct DenseTag {};
 struct InterceptTag {};
+struct InteractionTag {};
 
 template <typename Scalar>
 class ReverseIndicatorIterator;
@@ -465,6 +466,152 @@ protected:
     Index mId;
 };
 
+template <typename Scalar>
+class ReverseInteractionIterator;
+
+// Iterator for an INTERACTION column: merge-intersects the sorted row indices of its two
+// factor columns and yields the product of their values, so no storage is materialized
+template <typename Scalar>
+class InteractionIterator {
+  public:
+
+	typedef InteractionTag tag;
+	typedef int Index;
+	typedef Scalar ValueType;
+	typedef boost::tuples::tuple<Index, Scalar> XTuple;
+
+	const static std::string name;
+
+	static const bool isIndicatorStatic = false;
+	enum  { isIndicator = false };
+	enum  { isSparse = true };
+
+	inline InteractionIterator(const CompressedDataMatrix<Scalar>& mat, Index column)
+	  : mIndicesOne(mat.getColumn(column).getFirstColumnsVector().data()),
+	    mIndicesTwo(mat.getColumn(column).getSecondColumnsVector().data()),
+	    mValuesOne(mat.getColumn(column).getFirstValues()),
+	    mValuesTwo(mat.getColumn(column).getSecondValues()),
+	    mIdOne(0), mIdTwo(0),
+	    mEndOne(mat.getColumn(column).getFirstColumnsVector().size()),
+	    mEndTwo(mat.getColumn(column).getSecondColumnsVector().size()),
+	    mId(0), mEnd(mat.getNumberOfEntries(column)) {
+		advance();
+	}
+
+	// Plain index list (e.g. the strata touched by a column); intersects the list with itself
+	inline InteractionIterator(const std::vector<int>* vec, Index max = 0)
+	  : mIndicesOne(vec->data()), mIndicesTwo(vec->data()),
+	    mValuesOne(nullptr), mValuesTwo(nullptr),
+	    mIdOne(0), mIdTwo(0), mEndOne(vec->size()), mEndTwo(vec->size()),
+	    mId(0), mEnd(vec->size()) {
+		// Do nothing
+	}
+
+	inline InteractionIterator(const std::vector<int>& vec, Index max = 0)
+	  : InteractionIterator(&vec, max) { }
+
+    inline InteractionIterator& operator++() {
+    	++mIdOne;
+    	++mIdTwo;
+    	++mId;
+    	advance();
+    	return *this;
+    }
+
+    inline const Scalar value() const {
+    	return (mValuesOne ? mValuesOne[mIdOne] : static_cast<Scalar>(1)) *
+    		(mValuesTwo ? mValuesTwo[mIdTwo] : static_cast<Scalar>(1));
+    }
+
+    inline Index index() const { return mIndicesOne[mIdOne]; }
+	inline Index nextIndex() const { auto next = *this; ++next; return next.index(); }
+    inline operator bool() const { return (mIdOne < mEndOne && mIdTwo < mEndTwo); }
+	inline bool inRange(const Scalar i) const { return (mId < i); }
+    inline Index size() const { return mEnd; }
+	inline Scalar multiply(const Scalar x) const { return x * value(); }
+
+	ReverseInteractionIterator<Scalar> reverse() const {
+	    return ReverseInteractionIterator<Scalar>(*this);
+	}
+
+  protected:
+
+	friend class ReverseInteractionIterator<Scalar>;
+
+	inline void advance() {
+		while (mIdOne < mEndOne && mIdTwo < mEndTwo &&
+				mIndicesOne[mIdOne] != mIndicesTwo[mIdTwo]) {
+			if (mIndicesOne[mIdOne] < mIndicesTwo[mIdTwo]) {
+				++mIdOne;
+			} else {
+				++mIdTwo;
+			}
+		}
+	}
+
+    const Index* mIndicesOne;
+    const Index* mIndicesTwo;
+    const Scalar* mValuesOne;
+    const Scalar* mValuesTwo;
+    Index mIdOne;
+    Index mIdTwo;
+    Index mEndOne;
+    Index mEndTwo;
+    Index mId;
+    Index mEnd;
+};
+
+template <typename Scalar>
+class ReverseInteractionIterator {
+public:
+
+    typedef int Index;
+
+    inline ReverseInteractionIterator(const InteractionIterator<Scalar>& forward)
+        : mIndicesOne(forward.mIndicesOne), mIndicesTwo(forward.mIndicesTwo),
+          mValuesOne(forward.mValuesOne), mValuesTwo(forward.mValuesTwo),
+          mIdOne(forward.mEndOne - 1), mIdTwo(forward.mEndTwo - 1), mEnd(forward.mEnd) {
+        retreat();
+    }
+
+    inline ReverseInteractionIterator& operator--() {
+        --mIdOne;
+        --mIdTwo;
+        retreat();
+        return *this;
+    }
+
+    inline operator bool() const { return (mIdOne >= 0 && mIdTwo >= 0); }
+
+    inline const Scalar value() const {
+        return (mValuesOne ? mValuesOne[mIdOne] : static_cast<Scalar>(1)) *
+            (mValuesTwo ? mValuesTwo[mIdTwo] : static_cast<Scalar>(1));
+    }
+    inline Index index() const { return mIndicesOne[mIdOne]; }
+
+    inline Index size() const { return mEnd; }
+
+protected:
+
+    inline void retreat() {
+        while (mIdOne >= 0 && mIdTwo >= 0 && mIndicesOne[mIdOne] != mIndicesTwo[mIdTwo]) {
+            if (mIndicesOne[mIdOne] > mIndicesTwo[mIdTwo]) {
+                --mIdOne;
+            } else {
+                --mIdTwo;
+            }
+        }
+    }
+
+    const Index* mIndicesOne;
+    const Index* mIndicesTwo;
+    const Scalar* mValuesOne;
+    const Scalar* mValuesTwo;
+    Index mIdOne;
+    Index mIdTwo;
+    const Index mEnd;
+};
+
 // Iterator for a dense view of an arbitrary column
 template <typename Scalar>
 class DenseViewIterator {
@@ -511,7 +658,7 @@ class GenericIterator {
 
 	inline GenericIterator(const CompressedDataMatrix<Scalar>& mat, Index column)
 	  : mFormatType(mat.getFormatType(column)),
-	    mId(0) {
+	    mId(0), mIndicesTwo(NULL), mValuesTwo(NULL), mIdTwo(0), mEndTwo(0) {
 		if (mFormatType == DENSE) {
 			mValues = mat.getDataVector(column);
 			mIndices = NULL;
@@ -520,6 +667,15 @@ class GenericIterator {
 		    mValues = NULL;
 		    mIndices = NULL;
 		    mEnd = mat.getNumberOfRows();
+		} else if (mFormatType == INTERACTION) {
+			const auto& interaction = mat.getColumn(column);
+			mIndices = interaction.getFirstColumnsVector().data();
+			mValues = interaction.getFirstValues();
+			mEnd = interaction.getFirstColumnsVector().size();
+			mIndicesTwo = interaction.getSecondColumnsVector().data();
+			mValuesTwo = interaction.getSecondValues();
+			mEndTwo = interaction.getSecondColumnsVector().size();
+			advance();
 		} else {
 			if (mFormatType == SPARSE) {
 				mValues = mat.getDataVector(column);
@@ -529,13 +685,24 @@ class GenericIterator {
 			mIndices = mat.getCompressedColumnVector(column);
 			mEnd = mat.getNumberOfEntries(column);
 		}
+		mSize = (mFormatType == INTERACTION) ? mat.getNumberOfEntries(column) : mEnd;
 	}
 
-    inline GenericIterator& operator++() { ++mId; return *this; }
+    inline GenericIterator& operator++() {
+    	++mId;
+    	if (mFormatType == INTERACTION) {
+    		++mIdTwo;
+    		advance();
+    	}
+    	return *this;
+    }
 
     inline const Scalar value() const {
     	if (mFormatType == INDICATOR || mFormatType == INTERCEPT) {
     		return static_cast<Scalar>(1);
+    	} else if (mFormatType == INTERACTION) {
+    		return (mValues ? mValues[mId] : static_cast<Scalar>(1)) *
+    			(mValuesTwo ? mValuesTwo[mIdTwo] : static_cast<Scalar>(1));
     	} else {
     		return mValues[mId];
     	}
@@ -552,20 +719,40 @@ class GenericIterator {
 	inline Index nextIndex() const {
 	    if (mFormatType == DENSE || mFormatType == INTERCEPT) {
 	        return mId + 1;
+	    } else if (mFormatType == INTERACTION) {
+	        auto next = *this;
+	        ++next;
+	        return next.index();
 	    } else {
 	        return mIndices[mId + 1];
 	    }
 	}
-    inline operator bool() const { return (mId < mEnd); }
-    inline Index size() const { return mEnd; }
+    inline operator bool() const { return (mId < mEnd) && (mFormatType != INTERACTION || mIdTwo < mEndTwo); }
+    inline Index size() const { return mSize; }
 	inline Scalar multiply(const Scalar x) const { return x * value(); }
 
   protected:
+
+	inline void advance() {
+		while (mId < mEnd && mIdTwo < mEndTwo && mIndices[mId] != mIndicesTwo[mIdTwo]) {
+			if (mIndices[mId] < mIndicesTwo[mIdTwo]) {
+				++mId;
+			} else {
+				++mIdTwo;
+			}
+		}
+	}
+
     const FormatType mFormatType;
-    Scalar* mValues;
-    Index* mIndices;
+    const Scalar* mValues;
+    const Index* mIndices;
     Index mId;
     Index mEnd;
+    const Index* mIndicesTwo; // INTERACTION only
+    const Scalar* mValuesTwo;
+    Index mIdTwo;
+    Index mEndTwo;
+    Index mSize;
 };
 
 // Iterator for grouping by another IndicatorIterator
@@ -16,6 +16,7 @@
 #include <numeric>
 #include <list>
 #include <functional>
+#include <cmath>
 
 #include <boost/iterator/permutation_iterator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
@@ -33,7 +34,7 @@ ModelData<RealType>::ModelData(
     loggers::ProgressLoggerPtr _log,
     loggers::ErrorHandlerPtr _error
     ) : modelType(_modelType), nPatients(0), nStrata(0), hasOffsetCovariate(false), hasInterceptCovariate(false), isFinalized(false),
-        lastStratumMap(0,0), sparseIndexer(X), log(_log), error(_error), touchedY(true), touchedX(true) {
+        offsetCovariate(0), hasLogOffset(false), lastStratumMap(0,0), sparseIndexer(X), log(_log), error(_error), touchedY(true), touchedX(true) {
 	// Do nothing
 }
 
@@ -379,6 +380,18 @@ size_t ModelData<RealType>::append(
         const std::vector<IdType>& cCovariateId,
         const std::vector<double>& cCovariateValue) {
 
+    if (X.isOutOfCore()) {
+        std::ostringstream stream;
+        stream << "Cannot append to out-of-core data";
+        error->throwError(stream);
+    }
+
+    if (!columnMultiplicity.empty() || !rowMultiplicity.empty()) {
+        std::ostringstream stream;
+        stream << "Cannot append to data with collapsed columns or compressed rows";
+        error->throwError(stream);
+    }
+
     // Check covariate dimensions
     if ((cRowId.size() != cCovariateId.size()) ||
         (cRowId.size() != cCovariateValue.size())) {
@@ -400,6 +413,13 @@ size_t ModelData<RealType>::append(
 
     bool hasTime = oTime.size() == oY.size();
 
+    const bool offsetFromTime = hasOffsetCovariate && offsetCovariate == -1;
+    if (offsetFromTime && !hasTime) {
+        std::ostringstream stream;
+        stream << "Appended rows need times for the time offset";
+        error->throwError(stream);
+    }
+
     const size_t nOutcomes = oStratumId.size();
     const size_t nCovariates = cCovariateId.size();
 
@@ -443,16 +463,30 @@ size_t ModelData<RealType>::append(
 #ifdef DEBUG_64BIT
         std::cout << currentRowId << std::endl;
 #endif
+        if (offsetFromTime) {
+            X.getColumn(0).add_data(X.nRows, hasLogOffset ? std::log(oTime[i]) : oTime[i]);
+        }
+
         while (cOffset < nCovariates && cRowId[cOffset] == currentRowId) {
             auto covariate = cCovariateId[cOffset];
             auto value = cCovariateValue[cOffset];
 
-			if (!sparseIndexer.hasColumn(covariate)) {
-				// Add new column
-				sparseIndexer.addColumn(covariate, INDICATOR);
-			}
+            int index;
+            if (hasOffsetCovariate && covariate == offsetCovariate) {
+                index = 0; // The offset column no longer carries its covariate label
+                if (hasLogOffset) {
+                    value = std::log(value);
+                }
+            } else {
+                index = sparseIndexer.findIndex(covariate);
+                if (index == -1) {
+                    // Add new column
+                    sparseIndexer.addColumn(covariate, INDICATOR);
+                    index = getNumberOfColumns() - 1;
+                }
+            }
 
-			auto& column = sparseIndexer.getColumn(covariate);
+			auto& column = X.getColumn(index);
 			if (value != static_cast<RealType>(1) && value != static_cast<RealType>(0)) {
 				if (column.getFormatType() == INDICATOR) {
 					std::ostringstream stream;
@@ -475,11 +509,27 @@ size_t ModelData<RealType>::append(
         }
         ++X.nRows;
     }
+
+    // Dense columns hold every row; the intercept is one in appended rows
+    for (size_t j = 0; j < X.getNumberOfColumns(); ++j) {
+        auto& column = X.getColumn(j);
+        if (column.getFormatType() == DENSE && column.getDataVector().size() < X.nRows) {
+            const bool intercept = hasInterceptCovariate && j == (hasOffsetCovariate ? 1 : 0);
+            const RealType value = intercept ? static_cast<RealType>(1) : static_cast<RealType>(0);
+            column.getDataVector().resize(X.nRows, value);
+        }
+    }
     return nOutcomes;
 }
 
 template <typename RealType>
 std::vector<double> ModelData<RealType>::normalizeCovariates(const NormalizationType type) {
+    if (X.isOutOfCore()) {
+        std::ostringstream stream;
+        stream << "Cannot normalize out-of-core data";
+        error->throwError(stream);
+    }
+
     std::vector<double> normalizations;
     normalizations.reserve(getNumberOfColumns());
 
@@ -609,6 +659,7 @@ template <typename RealType>
 void ModelData<RealType>::addIntercept() {
     // TODO Use INTERCEPT
     X.insert(0, DENSE); // add to front, TODO fix if offset
+    sparseIndexer.insertColumn(0);
     setHasInterceptCovariate(true);
     const size_t numRows = getNumberOfRows();
     for (size_t i = 0; i < numRows; ++i) {
@@ -621,6 +672,9 @@ void ModelData<RealType>::logTransformCovariate(const IdType covariate) {
     X.getColumn(covariate).transform([](RealType x) {
         return std::log(x);
     });
+    if (hasOffsetCovariate && covariate == 0) {
+        hasLogOffset = true; // Appended offsets get the same transform
+    }
 }
 
 template <typename RealType>
@@ -629,6 +683,340 @@ void ModelData<RealType>::convertCovariateToDense(const IdType covariate) {
     X.getColumn(index).convertColumnToDense(getNumberOfRows());
 }
 
+template <typename RealType>
+void ModelData<RealType>::addInteraction(const IdType covariate, const IdType first, const IdType second) {
+    if (getColumnIndexByName(covariate) != -1) {
+        std::ostringstream stream;
+        stream << "Variable " << covariate << " already exists";
+        error->throwError(stream);
+    }
+    const size_t firstIndex = getColumnIndex(first);
+    const size_t secondIndex = getColumnIndex(second);
+    for (auto index : { firstIndex, secondIndex }) {
+        const auto format = X.getColumn(index).getFormatType();
+        if (format != SPARSE && format != INDICATOR) {
+            std::ostringstream stream;
+            stream << "Interactions are only supported between sparse or indicator covariates, "
+                   << "not " << X.getColumn(index).getTypeString() << " covariate "
+                   << X.getColumn(index).getNumericalLabel();
+            error->throwError(stream);
+        }
+    }
+    X.push_back_interaction(firstIndex, secondIndex, covariate);
+    touchedX = true;
+}
+
+namespace {
+
+template <typename T>
+inline void hashBytes(uint64_t& hash, const T* begin, size_t count) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(begin);
+    for (size_t i = 0; i < count * sizeof(T); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL; // FNV-1a
+    }
+}
+
+template <typename RealType>
+uint64_t hashColumn(const CompressedDataColumn<RealType>& column) {
+    uint64_t hash = 14695981039346656037ULL;
+    const int format = column.getFormatType();
+    hashBytes(hash, &format, 1);
+    if (format != DENSE) {
+        const auto& rows = column.getColumnsVector();
+        hashBytes(hash, rows.data(), rows.size());
+    }
+    if (format != INDICATOR) {
+        const auto& values = column.getDataVector();
+        hashBytes(hash, values.data(), values.size());
+    }
+    return hash;
+}
+
+} // namespace
+
+template <typename RealType>
+int ModelData<RealType>::collapseDuplicateColumns() {
+
+    const size_t J = getNumberOfColumns();
+    const size_t firstCovariate = hasOffsetCovariate ? 1 : 0;
+
+    // Group columns by hash, then confirm exact equality within each bucket
+    std::vector<size_t> representative(J);
+    bsccs::unordered_map<uint64_t, std::vector<size_t>> buckets;
+    int nDuplicates = 0;
+    for (size_t j = 0; j < J; ++j) {
+        representative[j] = j;
+        const auto& column = X.getColumn(j);
+        if (j < firstCovariate || column.getFormatType() == INTERCEPT ||
+                column.getFormatType() == INTERACTION ||
+                (hasInterceptCovariate && column.getNumericalLabel() == 0)) {
+            continue;
+        }
+        auto& bucket = buckets[hashColumn(column)];
+        for (auto candidate : bucket) {
+            if (X.getColumn(candidate).hasSameEntries(column)) {
+                representative[j] = candidate;
+                ++nDuplicates;
+                break;
+            }
+        }
+        if (representative[j] == j) {
+            bucket.push_back(j);
+        }
+    }
+
+    if (nDuplicates == 0) {
+        return 0;
+    }
+
+    std::vector<int> newIndex(J, -1);
+    std::vector<bool> remove(J, false);
+    int nKept = 0;
+    for (size_t j = 0; j < J; ++j) {
+        if (representative[j] == j) {
+            newIndex[j] = nKept++;
+        } else {
+            remove[j] = true;
+        }
+    }
+
+    columnMultiplicity.assign(nKept, 1);
+    collapsedLabels.clear();
+    collapsedIndex.clear();
+    for (size_t j = 0; j < J; ++j) {
+        const int index = newIndex[representative[j]];
+        if (remove[j]) {
+            ++columnMultiplicity[index];
+        }
+        if (j >= firstCovariate) {
+            collapsedLabels.push_back(X.getColumn(j).getNumericalLabel());
+            collapsedIndex.push_back(index);
+        }
+    }
+
+    X.erase(remove);
+    touchedX = true;
+
+    return nDuplicates;
+}
+
+namespace {
+
+template <typename T>
+void compressVector(std::vector<T>& values, const std::vector<int>& newRow, size_t nKept) {
+    if (values.size() != newRow.size()) {
+        return;
+    }
+    for (size_t k = 0; k < newRow.size(); ++k) {
+        if (newRow[k] >= 0) {
+            values[newRow[k]] = values[k];
+        }
+    }
+    values.resize(nKept);
+}
+
+} // namespace
+
+template <typename RealType>
+int ModelData<RealType>::compressRows() {
+
+    if (modelType != ModelType::LOGISTIC && modelType != ModelType::POISSON) {
+        std::ostringstream stream;
+        stream << "Row compression is only implemented for logistic and Poisson regression";
+        error->throwError(stream);
+    }
+
+    const size_t K = getNumberOfRows();
+    const size_t J = getNumberOfColumns();
+    const bool hasTime = offs.size() == K;
+    const bool hasStrata = pid.size() == K && static_cast<size_t>(nPatients) < K;
+
+    // Poisson rows with an exposure offset merge into one row with their summed counts and
+    // exposures; otherwise only identical rows merge, into one row weighted by their number
+    const bool sumOutcomes = modelType == ModelType::POISSON && hasOffsetCovariate;
+    const size_t firstKeyColumn = sumOutcomes ? 1 : 0;
+    std::vector<RealType> offset;
+    if (sumOutcomes) {
+        X.getColumn(0).convertColumnToDense(K);
+        const auto& values = X.getColumn(0).getDataVector();
+        offset.assign(values.begin(), values.end());
+    }
+
+    // Row-major copy of the (column, value) entries of each row
+    std::vector<size_t> start(K + 1, 0);
+    for (size_t j = firstKeyColumn; j < J; ++j) {
+        const auto& column = X.getColumn(j);
+        const auto format = column.getFormatType();
+        if (format == INTERCEPT || format == INTERACTION) {
+            continue; // INTERACTION entries follow from its factor columns
+        } else if (format == DENSE) {
+            for (size_t k = 0; k < K; ++k) {
+                ++start[k + 1];
+            }
+        } else {
+            for (auto k : column.getColumnsVector()) {
+                ++start[k + 1];
+            }
+        }
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+
+    std::vector<int> entryColumn(start[K]);
+    std::vector<RealType> entryValue(start[K]);
+    std::vector<size_t> position(start.begin(), start.end() - 1);
+    for (size_t j = firstKeyColumn; j < J; ++j) {
+        const auto& column = X.getColumn(j);
+        const auto format = column.getFormatType();
+        if (format == INTERCEPT || format == INTERACTION) {
+            continue;
+        } else if (format == DENSE) {
+            const auto& values = column.getDataVector();
+            for (size_t k = 0; k < K; ++k) {
+                entryColumn[position[k]] = j;
+                entryValue[position[k]++] = values[k];
+            }
+        } else {
+            const auto& rows = column.getColumnsVector();
+            for (size_t i = 0; i < rows.size(); ++i) {
+                const auto k = rows[i];
+                entryColumn[position[k]] = j;
+                entryValue[position[k]++] = (format == SPARSE) ?
+                    column.getDataVector()[i] : static_cast<RealType>(1);
+            }
+        }
+    }
+
+    auto hashRow = [&](size_t k) {
+        uint64_t hash = 14695981039346656037ULL;
+        if (!sumOutcomes) {
+            hashBytes(hash, &y[k], 1);
+        }
+        if (hasStrata) {
+            hashBytes(hash, &pid[k], 1);
+        }
+        hashBytes(hash, entryColumn.data() + start[k], start[k + 1] - start[k]);
+        hashBytes(hash, entryValue.data() + start[k], start[k + 1] - start[k]);
+        return hash;
+    };
+
+    auto sameRow = [&](size_t a, size_t b) {
+        return (sumOutcomes || y[a] == y[b]) && (!hasStrata || pid[a] == pid[b]) &&
+            start[a + 1] - start[a] == start[b + 1] - start[b] &&
+            std::equal(entryColumn.begin() + start[a], entryColumn.begin() + start[a + 1],
+                       entryColumn.begin() + start[b]) &&
+            std::equal(entryValue.begin() + start[a], entryValue.begin() + start[a + 1],
+                       entryValue.begin() + start[b]);
+    };
+
+    // Rows keep the order of their first occurrence
+    std::vector<int> newRow(K, -1);
+    std::vector<int> multiplicity;
+    std::vector<int> rowIndex(K);
+    bsccs::unordered_map<uint64_t, std::vector<size_t>> buckets;
+    for (size_t k = 0; k < K; ++k) {
+        auto& bucket = buckets[hashRow(k)];
+        bool found = false;
+        for (auto candidate : bucket) {
+            if (sameRow(candidate, k)) {
+                rowIndex[k] = newRow[candidate];
+                ++multiplicity[rowIndex[k]];
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            newRow[k] = rowIndex[k] = multiplicity.size();
+            multiplicity.push_back(1);
+            bucket.push_back(k);
+        }
+    }
+
+    const size_t nKept = multiplicity.size();
+    if (nKept == K) {
+        return 0;
+    }
+
+    std::vector<RealType> totalTime(nKept, 0);
+    std::vector<RealType> totalY(nKept, 0);
+    std::vector<RealType> totalExposure(nKept, 0);
+    std::vector<double> shift(nKept, 0.0);
+    auto logFactorial = [](RealType count) { // As in the Poisson fixed likelihood terms
+        return std::lgamma(static_cast<double>(static_cast<int>(count)) + 1.0);
+    };
+    for (size_t k = 0; k < K; ++k) {
+        if (hasTime) {
+            totalTime[rowIndex[k]] += offs[k];
+        }
+        if (sumOutcomes) {
+            totalY[rowIndex[k]] += y[k];
+            totalExposure[rowIndex[k]] += std::exp(offset[k]);
+            shift[rowIndex[k]] += y[k] * offset[k] - logFactorial(y[k]);
+        }
+    }
+
+    compressVector(y, newRow, nKept);
+    compressVector(offs, newRow, nKept);
+    compressVector(z, newRow, nKept);
+    compressVector(nevents, newRow, nKept);
+    if (labels.size() == K) {
+        uncompressedLabels = labels;
+        compressVector(labels, newRow, nKept);
+    }
+    if (hasTime) {
+        offs = totalTime;
+    }
+    if (hasStrata) {
+        compressVector(pid, newRow, nKept); // Strata stay contiguous and keep their count
+    } else {
+        pid.resize(nKept);
+        std::iota(pid.begin(), pid.end(), 0);
+        nPatients = nKept;
+    }
+    nStrata = 0;
+
+    X.compressRows(newRow, nKept);
+    touchedX = true;
+    touchedY = true;
+
+    if (sumOutcomes) {
+        auto& merged = X.getColumn(0).getDataVector();
+        for (size_t k = 0; k < nKept; ++k) {
+            y[k] = totalY[k];
+            merged[k] = std::log(totalExposure[k]);
+            shift[k] -= y[k] * merged[k] - logFactorial(y[k]);
+        }
+        compressedRowShare.resize(K);
+        for (size_t k = 0; k < K; ++k) {
+            compressedRowShare[k] = std::exp(offset[k] - merged[rowIndex[k]]);
+        }
+        rowLogLikelihoodShift = std::move(shift);
+        rowWeight.clear();
+    } else {
+        rowWeight = multiplicity;
+    }
+
+    rowMultiplicity = std::move(multiplicity);
+    compressedRowIndex = std::move(rowIndex);
+
+    return K - nKept;
+}
+
+template <typename RealType>
+void ModelData<RealType>::spillColumnsToFile(const std::string& fileName, size_t cacheBytes) {
+    if (X.hasInteractions()) {
+        std::ostringstream stream;
+        stream << "Interaction covariates cannot be kept out-of-core";
+        error->throwError(stream);
+    }
+    try {
+        X.spillToFile(fileName, cacheBytes);
+    } catch (const std::exception& e) {
+        std::ostringstream stream;
+        stream << e.what();
+        error->throwError(stream);
+    }
+}
+
 template <typename RealType>
 void ModelData<RealType>::convertAllCovariatesToDense(int length) {
     for (int index = 0; index < getNumberOfColumns(); ++index) {
@@ -648,6 +1036,7 @@ void ModelData<RealType>::setOffsetCovariate(const IdType covariate) {
     X.moveToFront(index);
     X.getColumn(0).add_label(-1); // TODO Generic label for offset?
     setHasOffsetCovariate(true);
+    offsetCovariate = covariate;
 }
 
 template <typename RealType>
@@ -661,6 +1050,17 @@ const RealType* ModelData<RealType>::getYVector() const { // TODO deprecated
 // 	y = y_;
 // }
 
+template <typename RealType>
+void ModelData<RealType>::setYVector(const std::vector<double>& newY) {
+    if (newY.size() != y.size()) {
+        std::ostringstream stream;
+        stream << "Outcome has " << newY.size() << " rows; expected " << y.size();
+        error->throwError(stream);
+    }
+    std::copy(newY.begin(), newY.end(), y.begin()); // In place; model specifics hold a reference
+    touchedY = true;
+}
+
 //int* ModelData::getNEventVector() { // TODO deprecated
 ////	return makeDeepCopy(&nevents[0], nevents.size());
 //	return &nevents[0];
@@ -767,6 +1167,46 @@ void ModelData<RealType>::sumByPid(std::vector<double>& out, const IdType covari
     }
 }
 
+template <typename RealType>
+std::vector<double> ModelData<RealType>::getFineGrayCensoringWeights() const {
+    // Kaplan-Meier estimate of the censoring distribution (y == 0 are the events), evaluated
+    // just before each row's time; matches getFineGrayWeights() in R
+    const size_t K = getNumberOfRows();
+    std::vector<double> weights(K);
+
+    // Rows are sorted by decreasing time within strata; only multiple strata need a sort
+    std::vector<size_t> order(K);
+    std::iota(std::begin(order), std::end(order), 0);
+    if (nPatients > 1) {
+        std::stable_sort(std::begin(order), std::end(order), [this](size_t lhs, size_t rhs) {
+            return offs[lhs] > offs[rhs];
+        });
+    }
+
+    // Walk in increasing time; rows at positions <= last are at risk at the current time
+    double survival = 1.0;
+    size_t end = K;
+    while (end > 0) {
+        const RealType time = offs[order[end - 1]];
+        size_t begin = end - 1;
+        while (begin > 0 && offs[order[begin - 1]] == time) {
+            --begin;
+        }
+
+        size_t censored = 0;
+        for (size_t i = begin; i < end; ++i) {
+            weights[order[i]] = survival;
+            if (y[order[i]] == static_cast<RealType>(0)) {
+                ++censored;
+            }
+        }
+        survival *= 1.0 - static_cast<double>(censored) / static_cast<double>(end);
+        end = begin;
+    }
+
+    return weights;
+}
+
 template <typename RealType>
 const std::string& ModelData<RealType>::getRowLabel(const size_t i) const {
     if (i >= labels.size()) {
@@ -92,10 +92,16 @@ public:
 
     virtual std::vector<double> copyYVector() const = 0;
 
+    virtual double getDataChecksum() const = 0;
+
+    virtual void setYVector(const std::vector<double>& y) = 0;
+
     virtual std::vector<double> copyTimeVector() const = 0;
 
     virtual std::vector<double> copyZVector() const = 0;
 
+    virtual std::vector<double> getFineGrayCensoringWeights() const = 0;
+
     virtual std::vector<double> univariableCorrelation(
             const std::vector<long>& covariateLabel) const = 0;
 
@@ -124,6 +130,34 @@ public:
 
     virtual void convertCovariateToDense(const IdType covariate) = 0;
 
+    virtual void addInteraction(const IdType covariate, const IdType first, const IdType second) = 0;
+
+    virtual int collapseDuplicateColumns() = 0;
+
+    virtual const std::vector<int>& getColumnMultiplicity() const = 0;
+
+    virtual const std::vector<IdType>& getCollapsedLabels() const = 0;
+
+    virtual const std::vector<int>& getCollapsedIndex() const = 0;
+
+    virtual int compressRows() = 0;
+
+    virtual const std::vector<int>& getRowMultiplicity() const = 0;
+
+    virtual const std::vector<int>& getRowWeight() const = 0;
+
+    virtual const std::vector<double>& getRowLogLikelihoodShift() const = 0;
+
+    virtual const std::vector<double>& getCompressedRowShare() const = 0;
+
+    virtual const std::vector<int>& getCompressedRowIndex() const = 0;
+
+    virtual const std::vector<std::string>& getUncompressedRowLabels() const = 0;
+
+    virtual void spillColumnsToFile(const std::string& fileName, size_t cacheBytes) = 0;
+
+    virtual bool getIsOutOfCore() const = 0;
+
 	virtual double innerProductWithOutcome(const size_t index) const = 0;
 
     virtual void loadY(
@@ -229,6 +263,7 @@ public:
             loggers::ErrorHandlerPtr _error
 			) :
 		modelType(_modelType), nPatients(0), nStrata(0), hasOffsetCovariate(false), hasInterceptCovariate(false), isFinalized(false)
+		, offsetCovariate(0), hasLogOffset(false)
 		, pid(_pid.begin(), _pid.end()) // copy
 		, y(_y.begin(), _y.end()) // copy
 		, z(_z.begin(), _z.end()) // copy
@@ -307,7 +342,7 @@ public:
 
 	const int* getPidVector() const;
 	const RealType* getYVector() const;
-	void setYVector(std::vector<double> y_);
+	void setYVector(const std::vector<double>& newY);
 	int* getNEventVector();
 	RealType* getOffsetVector();
 //	map<int, IdType> getDrugNameMap();
@@ -375,6 +410,71 @@ public:
 
 	void convertCovariateToDense(const IdType covariate);
 
+	// Appends covariate 'covariate' as the product of covariates 'first' and 'second' without
+	// storing its entries
+	void addInteraction(const IdType covariate, const IdType first, const IdType second);
+
+	// Keeps one physical column per set of identical covariate columns; returns the number removed
+	int collapseDuplicateColumns();
+
+	// Number of original covariates represented by each column (empty if nothing was collapsed)
+	const std::vector<int>& getColumnMultiplicity() const {
+		return columnMultiplicity;
+	}
+
+	// Labels of the original (non-offset) covariates, in their original order
+	const std::vector<IdType>& getCollapsedLabels() const {
+		return collapsedLabels;
+	}
+
+	// Column now holding each entry of getCollapsedLabels()
+	const std::vector<int>& getCollapsedIndex() const {
+		return collapsedIndex;
+	}
+
+	// Merges rows with identical covariates and stratum; Poisson rows with an offset sum their
+	// counts and exposures, other rows must also share their outcome and become one weighted row.
+	// Returns the number of rows removed
+	int compressRows();
+
+	// Number of original rows represented by each row (empty if nothing was compressed)
+	const std::vector<int>& getRowMultiplicity() const {
+		return rowMultiplicity;
+	}
+
+	// Likelihood weight of each row; empty unless compressed rows stand for identical copies
+	const std::vector<int>& getRowWeight() const {
+		return rowWeight;
+	}
+
+	// Log-likelihood constant of the original rows lost by summing them (empty if none)
+	const std::vector<double>& getRowLogLikelihoodShift() const {
+		return rowLogLikelihoodShift;
+	}
+
+	// Share of its compressed row's prediction that belongs to each original row (empty if none)
+	const std::vector<double>& getCompressedRowShare() const {
+		return compressedRowShare;
+	}
+
+	// Row now holding each original row
+	const std::vector<int>& getCompressedRowIndex() const {
+		return compressedRowIndex;
+	}
+
+	// Labels of the original rows, in their original order
+	const std::vector<std::string>& getUncompressedRowLabels() const {
+		return uncompressedLabels;
+	}
+
+	// Keeps the covariate columns in 'fileName' and pages them in on access through a cache of
+	// at most 'cacheBytes'; the data can no longer be changed
+	void spillColumnsToFile(const std::string& fileName, size_t cacheBytes);
+
+	bool getIsOutOfCore() const {
+		return X.isOutOfCore();
+	}
+
     size_t getNumberOfCovariates() const {
         return getNumberOfColumns();
     }
@@ -443,6 +543,8 @@ public:
 
 	void sumByPid(std::vector<double>& out, const IdType covariate, const int power = 1) const;
 
+	std::vector<double> getFineGrayCensoringWeights() const;
+
 	template <typename F>
 	void transform(const size_t index, F func) {
 	    switch (X.getFormatType(index)) {
@@ -458,6 +560,12 @@ public:
 	    case INTERCEPT :
 	        transformImpl<InterceptIterator<RealType>>(index, func);
 	        break;
+	    case INTERACTION : {
+	        std::ostringstream stream;
+	        stream << "Virtual interaction columns cannot be transformed in place.";
+	        error->throwError(stream);
+	        break;
+	    }
 	    }
 	}
 
@@ -480,6 +588,9 @@ public:
 	    case INTERCEPT :
 	        sum = reduceImpl<InterceptIterator<RealType>>(index, func);
 	        break;
+	    case INTERACTION :
+	        sum = reduceImpl<InteractionIterator<RealType>>(index, func);
+	        break;
 	    }
 	    return sum;
 	}
@@ -500,6 +611,9 @@ public:
 	    case INTERCEPT :
 	        sum = innerProductWithOutcomeImpl<InterceptIterator<RealType>>(index, func);
 	        break;
+	    case INTERACTION :
+	        sum = innerProductWithOutcomeImpl<InteractionIterator<RealType>>(index, func);
+	        break;
 	    }
 	    return sum;
 	}
@@ -508,6 +622,36 @@ public:
 		return innerProductWithOutcome(index, InnerProduct());
 	}
 
+	// Fingerprint of the outcomes and of every entry (row and value) of X; O(nnz)
+	double getDataChecksum() const {
+	    double checksum = 0.0;
+	    for (size_t k = 0; k < y.size(); ++k) {
+	        checksum += (k + 1) * y[k];
+	    }
+	    for (size_t index = 0; index < X.getNumberOfColumns(); ++index) {
+	        double column = 0.0;
+	        switch (X.getFormatType(index)) {
+	        case INDICATOR :
+	            column = checksumImpl<IndicatorIterator<RealType>>(index);
+	            break;
+	        case SPARSE :
+	            column = checksumImpl<SparseIterator<RealType>>(index);
+	            break;
+	        case DENSE :
+	            column = checksumImpl<DenseIterator<RealType>>(index);
+	            break;
+	        case INTERCEPT :
+	            column = checksumImpl<InterceptIterator<RealType>>(index);
+	            break;
+	        case INTERACTION :
+	            column = checksumImpl<InteractionIterator<RealType>>(index);
+	            break;
+	        }
+	        checksum += (index + 1) * (column + X.getFormatType(index));
+	    }
+	    return checksum;
+	}
+
 	template <typename T, typename F>
 	void reduceByGroup(T& out, const size_t reductionIndex, const size_t groupByIndex, F func) const {
 	    if (X.getFormatType(groupByIndex) != INDICATOR) {
@@ -528,6 +672,9 @@ public:
 	    case INTERCEPT :
 	        reduceByGroupImpl<InterceptIterator<RealType>>(out, reductionIndex, groupByIndex, func);
 	        break;
+	    case INTERACTION :
+	        reduceByGroupImpl<InteractionIterator<RealType>>(out, reductionIndex, groupByIndex, func);
+	        break;
 	    }
 	}
 
@@ -647,6 +794,9 @@ protected:
         case INTERCEPT :
             binaryReductionByGroup<InterceptIterator<RealType>>(out, reductionIndex, groups, func);
             break;
+        case INTERACTION :
+            binaryReductionByGroup<InteractionIterator<RealType>>(out, reductionIndex, groups, func);
+            break;
 
         }
     }
@@ -675,6 +825,9 @@ protected:
         case INTERCEPT :
             reduceByGroupImpl<InterceptIterator<RealType>>(out, reductionIndex, groups, func);
             break;
+        case INTERACTION :
+            reduceByGroupImpl<InteractionIterator<RealType>>(out, reductionIndex, groups, func);
+            break;
 
         }
     }
@@ -726,6 +879,16 @@ protected:
         return sum;
     }
 
+    template <typename IteratorType>
+    double checksumImpl(const size_t index) const {
+        double sum = 0.0;
+        IteratorType it(X, index);
+        for (; it; ++it) {
+            sum += (it.index() + 1) * static_cast<double>(it.value());
+        }
+        return sum;
+    }
+
     template <typename IteratorType, typename F>
     double innerProductWithOutcomeImpl(const size_t index, F func) const {
         double sum = 0.0;
@@ -744,6 +907,8 @@ protected:
 	bool hasOffsetCovariate;
 	bool hasInterceptCovariate;
 	bool isFinalized;
+	IdType offsetCovariate; // Source of the offset column, -1 for time
+	bool hasLogOffset; // Offset column was log-transformed at finalization
 
 	IntVector pid;
 	RealVector y;
@@ -755,6 +920,17 @@ protected:
 
 	int nTypes;
 
+	std::vector<int> columnMultiplicity;
+	std::vector<IdType> collapsedLabels;
+	std::vector<int> collapsedIndex;
+
+	std::vector<int> rowMultiplicity;
+	std::vector<int> rowWeight;
+	std::vector<double> rowLogLikelihoodShift;
+	std::vector<int> compressedRowIndex;
+	std::vector<double> compressedRowShare;
+	std::vector<std::string> uncompressedLabels;
+
 private:
 	// Disable copy-constructors and copy-assignment
 	ModelData(const ModelData&);
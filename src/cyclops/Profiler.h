@@ -0,0 +1,122 @@
+/*
+ * Profiler.h
+ *
+ * Always-compiled, runtime-toggled phase timing for the engine. When disabled, a ScopedTimer
+ * costs one branch and never reads the clock.
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Timing.h"
+
+namespace bsccs {
+
+enum class ProfilePhase {
+	GRADIENT_HESSIAN,
+	MM_GRADIENT_HESSIAN,
+	NUMERATOR_FOR_GRADIENT,
+	UPDATE_XBETA,
+	COMPUTE_XBETA,
+	REMAINING_STATISTICS,
+	LOG_LIKELIHOOD,
+	SET_WEIGHTS,
+	KKT_ROUND,
+	KKT_CHECK,
+	COUNT
+};
+
+class Profiler {
+public:
+
+	// Column formats follow FormatType (DENSE, SPARSE, INDICATOR, INTERCEPT,
+	// INTERACTION); NO_FORMAT marks phases that are not tied to a single column
+	static const int NO_FORMAT = -1;
+
+	struct Entry {
+		std::string phase;
+		std::string format;
+		long long calls;
+		long long nanoseconds;
+	};
+
+	Profiler() : enabled(false) { reset(); }
+
+	bool isEnabled() const { return enabled; }
+
+	void setEnabled(bool value) {
+		enabled = value;
+		reset();
+	}
+
+	void reset() {
+		calls.fill(0);
+		nanoseconds.fill(0);
+	}
+
+	void record(ProfilePhase phase, int format, long long elapsed) {
+		const int slot = static_cast<int>(phase) * nFormats + (format + 1);
+		++calls[slot];
+		nanoseconds[slot] += elapsed;
+	}
+
+	std::vector<Entry> getEntries() const {
+		static const char* phaseNames[] = {
+			"computeGradientAndHessian", "computeMMGradientAndHessian", "computeNumeratorForGradient",
+			"updateXBeta", "computeXBeta", "computeRemainingStatistics", "getLogLikelihood",
+			"setWeights", "kktRound", "kktCheck"
+		};
+		static const char* formatNames[] = { "", "dense", "sparse", "indicator", "intercept", "interaction" };
+
+		std::vector<Entry> entries;
+		for (int slot = 0; slot < nSlots; ++slot) {
+			if (calls[slot] > 0) {
+				entries.push_back(Entry{
+					phaseNames[slot / nFormats], formatNames[slot % nFormats],
+					calls[slot], nanoseconds[slot]
+				});
+			}
+		}
+		return entries;
+	}
+
+private:
+	static const int nFormats = 6;
+	static const int nSlots = static_cast<int>(ProfilePhase::COUNT) * nFormats;
+
+	bool enabled;
+	std::array<long long, nSlots> calls;
+	std::array<long long, nSlots> nanoseconds;
+};
+
+class ScopedTimer {
+public:
+	ScopedTimer(Profiler& profiler, ProfilePhase phase, int format = Profiler::NO_FORMAT)
+		: profiler(profiler.isEnabled() ? &profiler : nullptr), phase(phase), format(format) {
+		if (this->profiler) {
+			start = chrono::steady_clock::now();
+		}
+	}
+
+	~ScopedTimer() {
+		if (profiler) {
+			const auto end = chrono::steady_clock::now();
+			profiler->record(phase, format,
+				chrono::duration_cast<chrono::TimingUnits>(end - start).count());
+		}
+	}
+
+private:
+	Profiler* profiler;
+	ProfilePhase phase;
+	int format;
+	chrono::steady_clock::time_point start;
+};
+
+} // namespace bsccs
+
+#endif /* PROFILER_H_ */
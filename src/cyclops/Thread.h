@@ -4,7 +4,13 @@
 #include <algorithm>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include <vector>
 #include "tinythread/tinythread.h"
+#include "Types.h"
 
 #if defined(_WIN32) || defined(__WIN32__) || defined(__WINDOWS__) || defined(WIN_BUILD)
     #define USE_TTHREAD
@@ -12,6 +18,11 @@
     #undef USE_TTHREAD
 #endif
 
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
 namespace bsccs {
 #ifdef USE_TTHREAD
     using tthread::mutex;
@@ -60,11 +71,198 @@ namespace tthread {
 }
 }
 
+// Persistent fork-join workers.  Threads are started on first demand and then reused by every
+// parallel region until shutdown(); the submitting thread always participates.  A region
+// entered from inside a running region executes inline, so nested submission cannot deadlock.
+//
+// Tasks are dealt out cyclically by participant (task i runs on the caller when
+// i % nThreads == 0 and on worker i % nThreads - 1 otherwise), so a region with one task per
+// thread always places task i on the same thread.  Per-thread state that is first written
+// inside such a region therefore stays local to the thread that later uses it.
+class WorkerPool {
+public:
+
+	WorkerPool() : jobTasks(0), participants(0), active(0), generation(0), stop(false),
+		affinity(false) { }
+
+	~WorkerPool() { shutdown(); }
+
+	// Calls function(i) for i in [0, nTasks) using up to nThreads threads; blocks until done
+	template <typename Function>
+	void run(size_t nTasks, size_t nThreads, Function function) {
+		nThreads = std::min(nThreads, nTasks);
+		if (nThreads <= 1 || insideRegion()) {
+			for (size_t i = 0; i < nTasks; ++i) {
+				function(i);
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> region(submit);
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (stop) {
+				throw std::runtime_error("Worker pool has been shut down");
+			}
+			ensureWorkers(nThreads - 1);
+			job = [&function](size_t i) { function(i); };
+			jobTasks = nTasks;
+			participants = nThreads;
+			active = nThreads - 1;
+			failure = nullptr;
+			++generation;
+		}
+		wake.notify_all();
+
+		drain(0);
+
+		std::unique_lock<std::mutex> guard(lock);
+		finished.wait(guard, [this] { return active == 0; });
+		participants = 0;
+		job = nullptr;
+		if (failure) {
+			std::rethrow_exception(failure);
+		}
+	}
+
+	void shutdown() {
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (stop) return;
+			stop = true;
+		}
+		wake.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+		workers.clear();
+	}
+
+	size_t getWorkerCount() const { return workers.size(); }
+
+	// Pins worker k to the (k + 1)-th CPU this process may run on (the submitting thread is left
+	// alone); takes effect at each worker's next region.  Only honoured on Linux.
+	void setAffinity(bool value) {
+		std::lock_guard<std::mutex> guard(lock);
+		affinity = value;
+	}
+
+	bool getAffinity() const { return affinity; }
+
+private:
+
+	static bool& insideRegion() {
+		static thread_local bool inside = false;
+		return inside;
+	}
+
+	void ensureWorkers(size_t count) { // Requires lock
+		while (workers.size() < count) {
+			workers.emplace_back(&WorkerPool::workerLoop, this, workers.size(), generation);
+		}
+	}
+
+	// CPUs in the calling thread's affinity mask, which honours taskset, cpusets and container
+	// limits; empty where the mask cannot be read
+	static std::vector<int> getAllowedCpus() {
+		std::vector<int> cpus;
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+			for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+				if (CPU_ISSET(cpu, &set)) {
+					cpus.push_back(cpu);
+				}
+			}
+		}
+#endif
+		return cpus;
+	}
+
+	static void pinToCpu(const std::vector<int>& allowed, size_t index, bool pin) {
+#if defined(__linux__)
+		if (allowed.empty()) return;
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (pin) {
+			CPU_SET(allowed[index % allowed.size()], &set);
+		} else {
+			for (int cpu : allowed) {
+				CPU_SET(cpu, &set);
+			}
+		}
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // Best effort
+#endif
+	}
+
+	void drain(size_t participant) {
+		insideRegion() = true;
+		for (size_t i = participant; i < jobTasks; i += participants) {
+			try {
+				job(i);
+			} catch (...) {
+				std::lock_guard<std::mutex> guard(lock);
+				if (!failure) {
+					failure = std::current_exception();
+				}
+			}
+		}
+		insideRegion() = false;
+	}
+
+	void workerLoop(size_t index, unsigned long seen) {
+		const std::vector<int> allowed = getAllowedCpus(); // Inherited from the creating thread
+		bool pinned = false;
+		for (;;) {
+			bool pin;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				wake.wait(guard, [this, seen] { return stop || generation != seen; });
+				if (stop) return;
+				seen = generation;
+				if (index + 1 >= participants) continue;
+				pin = affinity;
+			}
+
+			if (pin != pinned) {
+				pinToCpu(allowed, index + 1, pin);
+				pinned = pin;
+			}
+
+			drain(index + 1);
+
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				--active;
+			}
+			finished.notify_all();
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::mutex submit;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable finished;
+
+	std::function<void(size_t)> job;
+	size_t jobTasks;
+	size_t participants;
+	size_t active;
+	unsigned long generation;
+	bool stop;
+	bool affinity;
+	std::exception_ptr failure;
+};
+
+typedef bsccs::shared_ptr<WorkerPool> WorkerPoolPtr;
+
 template <typename InputIt>
 struct TaskScheduler {
 
-	TaskScheduler(InputIt begin, InputIt end, const size_t nThreads)
-	   : begin(begin), end(end),
+	TaskScheduler(InputIt begin, InputIt end, const size_t nThreads, WorkerPool* pool = nullptr)
+	   : begin(begin), end(end), pool(pool),
 	     taskCount(std::distance(begin, end)),
 	     nThreads(std::min(nThreads, taskCount)),
 	     chunkSize(
@@ -73,6 +271,11 @@ struct TaskScheduler {
 
     template <typename UnaryFunction>
     UnaryFunction execute(UnaryFunction function) {
+#ifndef USE_TTHREAD
+        if (pool) {
+            return execute(function, *pool);
+        }
+#endif
         return execute(function, DefaultThreadType());
     }
 
@@ -112,6 +315,18 @@ private:
 		return rtn;
 	}
 #else
+    template <typename UnaryFunction>
+	UnaryFunction execute(UnaryFunction function, WorkerPool& workers) {
+
+		const size_t nChunks = (taskCount + chunkSize - 1) / chunkSize;
+		workers.run(nChunks, nThreads, [this, &function](size_t chunk) {
+			auto first = begin + chunk * chunkSize;
+			auto last = (chunk + 1) * chunkSize < taskCount ? first + chunkSize : end;
+			std::for_each(first, last, UnaryFunction(function)); // Each chunk gets its own copy
+		});
+		return function;
+	}
+
     template <typename UnaryFunction>
 	UnaryFunction execute(UnaryFunction function, threading::std_thread) {
 
@@ -136,6 +351,7 @@ private:
 
 	const InputIt begin;
 	const InputIt end;
+	WorkerPool* pool;
 	const size_t taskCount;
 	const size_t nThreads;
 	const size_t chunkSize;
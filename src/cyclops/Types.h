@@ -149,6 +149,9 @@ enum class ModelType {
 enum class AlgorithmType {
 	CCD = 0,
 	MM,
+	NEWTON,
+	LBFGS,
+	SHOTGUN,
 	SIZE_OF_ENUM // Keep at end
 };
 
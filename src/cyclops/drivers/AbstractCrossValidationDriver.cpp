@@ -7,12 +7,15 @@
 
 #include <numeric>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 
 #include "boost/iterator/counting_iterator.hpp"
 
 #include "Types.h"
 #include "Thread.h"
 #include "AbstractCrossValidationDriver.h"
+#include "io/BinaryStream.h"
 
 namespace bsccs {
 
@@ -20,7 +23,7 @@ AbstractCrossValidationDriver::AbstractCrossValidationDriver(
 			loggers::ProgressLoggerPtr _logger,
 			loggers::ErrorHandlerPtr _error,
 			std::vector<double>* wtsExclude
-	) : AbstractDriver(_logger, _error), weightsExclude(wtsExclude) {
+	) : AbstractDriver(_logger, _error), weightsExclude(wtsExclude), pendingCheckpoints(0) {
 	// Do nothing
 }
 
@@ -57,19 +60,18 @@ void AbstractCrossValidationDriver::drive(
     if (nThreads < 1) {
         nThreads = 1;
     }
+    nThreads = ccd.getUsableThreads(nThreads);
 
 	std::ostringstream stream2;
 	stream2 << "Using " << nThreads << " thread(s)";
 	logger->writeLine(stream2);
 
-	std::vector<CyclicCoordinateDescent*> ccdPool;
+	std::vector<CyclicCoordinateDescent*> ccdPool = ccd.cloneForThreads(nThreads);
 	std::vector<AbstractSelector*> selectorPool;
 
-	ccdPool.push_back(&ccd);
 	selectorPool.push_back(&selector);
 
 	for (int i = 1; i < nThreads; ++i) {
-		ccdPool.push_back(ccd.clone());
 		selectorPool.push_back(selector.clone());
 	}
 
@@ -94,9 +96,13 @@ void AbstractCrossValidationDriver::drive(
     }
 	// End of multi-thread set-up
 
+	loadCheckpoints(ccd, allArguments);
+
 	// Delegate to auto or grid loop
     maxPoint = doCrossValidationLoop(ccd, selector, allArguments, nThreads, ccdPool, selectorPool);
 
+	saveCheckpoints(ccd, allArguments);
+
 	// Clean up
 	for (int i = 1; i < nThreads; ++i) {
 		delete ccdPool[i];
@@ -138,22 +144,105 @@ double AbstractCrossValidationDriver::doCrossValidationStep(
 		std::vector<AbstractSelector*>& selectorPool,
 		std::vector<double>& predLogLikelihood){
 
+	std::vector<std::vector<double>> predLogLikelihoods;
+	const std::vector<double> pointEstimates = doCrossValidationBatch(ccd, selector, allArguments,
+		step, nThreads, ccdPool, selectorPool,
+		std::vector<std::vector<double>>(1, ccd.getHyperprior()), predLogLikelihoods);
+	predLogLikelihood = predLogLikelihoods[0];
+	return pointEstimates[0];
+}
+
+bool AbstractCrossValidationDriver::findCheckpoint(
+		const std::vector<double>& point,
+		int step,
+		std::vector<double>& predLogLikelihood) {
+
+	for (const auto& checkpoint : checkpoints) {
+		if (checkpoint.point == point) {
+			predLogLikelihood = checkpoint.predLogLikelihood;
+
+			std::ostringstream stream;
+			stream << "Grid-point #" << (step + 1) << " at ";
+			std::copy(point.begin(), point.end(), std::ostream_iterator<double>(stream, " "));
+			stream << "restored from checkpoint";
+			logger->writeLine(stream);
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<double> AbstractCrossValidationDriver::doCrossValidationBatch(
+		CyclicCoordinateDescent& ccd,
+		AbstractSelector& selector,
+		const CCDArguments& allArguments,
+		int step,
+		int nThreads,
+		std::vector<CyclicCoordinateDescent*>& ccdPool,
+		std::vector<AbstractSelector*>& selectorPool,
+		const std::vector<std::vector<double>>& points,
+		std::vector<std::vector<double>>& predLogLikelihoods) {
+
     const auto& arguments = allArguments.crossValidation;
     bool coldStart = allArguments.resetCoefficients;
 
-	predLogLikelihood.resize(arguments.foldToCompute);
+	predLogLikelihoods.assign(points.size(), std::vector<double>());
+	std::vector<int> pending;
+	for (int p = 0; p < static_cast<int>(points.size()); ++p) {
+		if (arguments.checkpointFileName.empty() ||
+				!findCheckpoint(points[p], step + p, predLogLikelihoods[p])) {
+			predLogLikelihoods[p].resize(arguments.foldToCompute);
+			pending.push_back(p);
+		}
+	}
+
+	// Points fit at the same time need their own priors; otherwise the pool shares one
+	std::vector<priors::JointPriorPtr> sharedPriors;
+	bool concurrent = pending.size() > 1 && nThreads > 1;
+	if (concurrent) {
+		for (auto ccdTask : ccdPool) {
+			sharedPriors.push_back(ccdTask->getPrior());
+			priors::JointPriorPtr copy = sharedPriors.back()->clone();
+			if (!copy) {
+				concurrent = false;
+				break;
+			}
+			ccdTask->setPrior(copy);
+		}
+		if (!concurrent) {
+			for (size_t i = 0; i < sharedPriors.size(); ++i) {
+				ccdPool[i]->setPrior(sharedPriors[i]);
+			}
+			sharedPriors.clear();
+		}
+	}
+
+	if (pending.size() > 1 && !concurrent) { // Fit one point at a time
+		for (int p : pending) {
+			std::vector<std::vector<double>> single;
+			doCrossValidationBatch(ccd, selector, allArguments, step + p, nThreads, ccdPool,
+				selectorPool, std::vector<std::vector<double>>(1, points[p]), single);
+			predLogLikelihoods[p] = single[0];
+		}
+		pending.clear();
+	} else if (pending.size() == 1) {
+		const auto& point = points[pending[0]];
+		for (size_t dim = 0; dim < point.size(); ++dim) {
+			ccd.setHyperprior(dim, point[dim]);
+		}
+	}
 
 	auto& weightsExclude = this->weightsExclude;
 	auto& logger = this->logger;
 
 	auto scheduler = TaskScheduler<decltype(boost::make_counting_iterator(0))>(
 		boost::make_counting_iterator(0),
-		boost::make_counting_iterator(arguments.foldToCompute),
-		nThreads);
+		boost::make_counting_iterator(static_cast<int>(pending.size()) * arguments.foldToCompute),
+		nThreads, ccd.getWorkerPool());
 
 	auto oneTask =
-		[step, coldStart, nThreads, &ccdPool, &selectorPool,
-		&arguments, &allArguments, &predLogLikelihood,
+		[step, coldStart, nThreads, concurrent, &ccdPool, &selectorPool,
+		&arguments, &allArguments, &points, &pending, &predLogLikelihoods,
 			&weightsExclude, &logger //, &lock
 		 //    ,&ccd, &selector
 		 		, &scheduler
@@ -163,19 +252,28 @@ double AbstractCrossValidationDriver::doCrossValidationStep(
 				auto ccdTask = ccdPool[uniqueId];
 				auto selectorTask = selectorPool[uniqueId];
 
+				// Each point runs every fold; tasks are ordered by point, then fold
+				const int point = pending[task / arguments.foldToCompute];
+				const int foldTask = task % arguments.foldToCompute;
+				if (concurrent) {
+					for (size_t dim = 0; dim < points[point].size(); ++dim) {
+						ccdTask->setHyperprior(dim, points[point][dim]);
+					}
+				}
+
 				// Bring selector up-to-date
-				if (task == 0 || nThreads > 1) {
+				if (foldTask == 0 || nThreads > 1) {
     				selectorTask->reseed();
     			}
-    			int i = (nThreads == 1) ? task : 0;
-				for ( ; i <= task; ++i) {
+    			int i = (nThreads == 1) ? foldTask : 0;
+				for ( ; i <= foldTask; ++i) {
 					int fold = i % arguments.fold;
 					if (fold == 0) {
 						selectorTask->permute();
 					}
 				}
 
-				int fold = task % arguments.fold;
+				int fold = foldTask % arguments.fold;
 
 				// Get this fold and update
 				std::vector<double> weights; // Task-specific
@@ -191,12 +289,12 @@ double AbstractCrossValidationDriver::doCrossValidationStep(
 
 				std::ostringstream stream;
 				stream << "Running at " << ccdTask->getPriorInfo() << " ";
-				stream << "Grid-point #" << (step + 1) << " at ";
+				stream << "Grid-point #" << (step + point + 1) << " at ";
 				std::vector<double> hyperprior = ccdTask->getHyperprior();
 				std::copy(hyperprior.begin(), hyperprior.end(),
 					std::ostream_iterator<double>(stream, " "));
 				stream << "\tFold #" << (fold + 1)
-						  << " Rep #" << (task / arguments.fold + 1) << " pred log like = ";
+						  << " Rep #" << (foldTask / arguments.fold + 1) << " pred log like = ";
 
 				if (coldStart) {
 			        ccdTask->resetBeta();
@@ -220,11 +318,11 @@ double AbstractCrossValidationDriver::doCrossValidationStep(
 
 					// Store value
 					stream << logLikelihood;
-					predLogLikelihood[task] = logLikelihood;
+					predLogLikelihoods[point][foldTask] = logLikelihood;
 				} else {
 					ccdTask->resetBeta(); // cold start for stability
 					stream << "Not computed";
-					predLogLikelihood[task] = std::numeric_limits<double>::quiet_NaN();
+					predLogLikelihoods[point][foldTask] = std::numeric_limits<double>::quiet_NaN();
 				}
 
                 bool write = true;
@@ -233,18 +331,150 @@ double AbstractCrossValidationDriver::doCrossValidationStep(
 			};
 
 	// Run all tasks in parallel
-	if (nThreads > 1) {
-    	ccd.getProgressLogger().setConcurrent(true);
-    }
-	scheduler.execute(oneTask);
-	if (nThreads > 1) {
-    	ccd.getProgressLogger().setConcurrent(false);
-     	ccd.getProgressLogger().flush();
-     }
+	if (!pending.empty()) {
+		if (nThreads > 1) {
+			ccd.getProgressLogger().setConcurrent(true);
+		}
+		scheduler.execute(oneTask);
+		if (nThreads > 1) {
+			ccd.getProgressLogger().setConcurrent(false);
+			ccd.getProgressLogger().flush();
+		}
+	}
 
-	double pointEstimate = computePointEstimate(predLogLikelihood);
+	for (size_t i = 0; i < sharedPriors.size(); ++i) {
+		ccdPool[i]->setPrior(sharedPriors[i]);
+	}
 
-	return(pointEstimate);
+	if (!arguments.checkpointFileName.empty() && !pending.empty()) {
+		for (int p : pending) {
+			checkpoints.push_back(Checkpoint{points[p], predLogLikelihoods[p]});
+			++pendingCheckpoints;
+		}
+		if (pendingCheckpoints >= arguments.checkpointInterval) {
+			saveCheckpoints(ccd, allArguments);
+		}
+	}
+
+	std::vector<double> pointEstimates;
+	for (const auto& predLogLikelihood : predLogLikelihoods) {
+		pointEstimates.push_back(computePointEstimate(predLogLikelihood));
+	}
+	return pointEstimates;
+}
+
+namespace {
+const char* CHECKPOINT_TAG = "CYCV";
+const int CHECKPOINT_VERSION = 2;
+
+// Prior types without their variances, which the search changes
+std::string getPriorTypes(const CyclicCoordinateDescent& ccd) {
+	const std::string description = ccd.getPriorInfo();
+	std::string types;
+	int depth = 0;
+	for (char c : description) {
+		if (c == '(') {
+			++depth;
+		} else if (c == ')') {
+			--depth;
+		} else if (depth == 0) {
+			types += c;
+		}
+	}
+	return types;
+}
+}
+
+void AbstractCrossValidationDriver::loadCheckpoints(const CyclicCoordinateDescent& ccd,
+		const CCDArguments& allArguments) {
+
+	const auto& arguments = allArguments.crossValidation;
+	checkpoints.clear();
+	pendingCheckpoints = 0;
+
+	if (arguments.checkpointFileName.empty()) {
+		return;
+	}
+
+	std::ifstream inFile(arguments.checkpointFileName.c_str(), std::ios::binary);
+	if (!inFile) {
+		return; // Nothing saved yet
+	}
+
+	// Steps are only reusable under the same fold assignment, data, model and priors
+	std::int64_t seed;
+	int fold, foldToCompute, modelType;
+	double checksum;
+	std::string priorTypes;
+	std::uint64_t count;
+	bool valid = binary::readHeader(inFile, CHECKPOINT_TAG, CHECKPOINT_VERSION) &&
+		binary::read(inFile, seed) && binary::read(inFile, fold) &&
+		binary::read(inFile, foldToCompute) && binary::read(inFile, modelType) &&
+		binary::read(inFile, checksum) && binary::read(inFile, priorTypes) &&
+		binary::read(inFile, count) &&
+		seed == allArguments.seed && fold == arguments.fold &&
+		foldToCompute == arguments.foldToCompute &&
+		modelType == static_cast<int>(ccd.getModelType()) &&
+		checksum == ccd.computeDataChecksum() && priorTypes == getPriorTypes(ccd);
+
+	for (std::uint64_t i = 0; valid && i < count; ++i) {
+		Checkpoint checkpoint;
+		valid = binary::read(inFile, checkpoint.point) &&
+			binary::read(inFile, checkpoint.predLogLikelihood);
+		if (valid) {
+			checkpoints.push_back(checkpoint);
+		}
+	}
+
+	std::ostringstream stream;
+	if (valid) {
+		stream << "Restored " << checkpoints.size() << " cross-validation step(s) from "
+		       << arguments.checkpointFileName;
+	} else {
+		checkpoints.clear();
+		stream << "Ignoring checkpoint " << arguments.checkpointFileName
+		       << " from a different cross-validation set-up";
+	}
+	logger->writeLine(stream);
+}
+
+void AbstractCrossValidationDriver::saveCheckpoints(const CyclicCoordinateDescent& ccd,
+		const CCDArguments& allArguments) {
+
+	const auto& arguments = allArguments.crossValidation;
+	if (arguments.checkpointFileName.empty() || pendingCheckpoints == 0) {
+		return;
+	}
+
+	// Write aside and rename, so a job stopped mid-write keeps the previous checkpoint
+	const std::string fileName = arguments.checkpointFileName;
+	const std::string tmpFileName = fileName + ".tmp";
+	std::ofstream outFile(tmpFileName.c_str(), std::ios::binary);
+	if (!outFile) {
+		std::ostringstream stream;
+		stream << "Unable to open checkpoint file: " << tmpFileName;
+		error->throwError(stream);
+	}
+
+	binary::writeHeader(outFile, CHECKPOINT_TAG, CHECKPOINT_VERSION);
+	binary::write(outFile, static_cast<std::int64_t>(allArguments.seed));
+	binary::write(outFile, arguments.fold);
+	binary::write(outFile, arguments.foldToCompute);
+	binary::write(outFile, static_cast<int>(ccd.getModelType()));
+	binary::write(outFile, ccd.computeDataChecksum());
+	binary::write(outFile, getPriorTypes(ccd));
+	binary::write(outFile, static_cast<std::uint64_t>(checkpoints.size()));
+	for (const auto& checkpoint : checkpoints) {
+		binary::write(outFile, checkpoint.point);
+		binary::write(outFile, checkpoint.predLogLikelihood);
+	}
+	outFile.close();
+
+	if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+		std::remove(fileName.c_str()); // Windows does not replace existing files
+		std::rename(tmpFileName.c_str(), fileName.c_str());
+	}
+	pendingCheckpoints = 0;
 }
 
 double AbstractCrossValidationDriver::computePointEstimate(const std::vector<double>& value) {
@@ -65,12 +65,40 @@ protected:
 			std::vector<AbstractSelector*>& selectorPool,
 			std::vector<double> & predLogLikelihood);
 
+	// Cross-validates several hyperparameter points at once, spreading points and folds over
+	// the pool; returns the point estimate at each
+	std::vector<double> doCrossValidationBatch(
+			CyclicCoordinateDescent& ccd,
+			AbstractSelector& selector,
+			const CCDArguments& arguments,
+			int step,
+			int nThreads,
+			std::vector<CyclicCoordinateDescent*>& ccdPool,
+			std::vector<AbstractSelector*>& selectorPool,
+			const std::vector<std::vector<double>>& points,
+			std::vector<std::vector<double>>& predLogLikelihoods);
+
+	bool findCheckpoint(const std::vector<double>& point, int step,
+			std::vector<double>& predLogLikelihood);
+
 	double computePointEstimate(const std::vector<double>& value);
 
+	void loadCheckpoints(const CyclicCoordinateDescent& ccd, const CCDArguments& arguments);
+
+	void saveCheckpoints(const CyclicCoordinateDescent& ccd, const CCDArguments& arguments);
+
 	double computeStDev(const std::vector<double>& value, double mean);
 
 	MaxPoint maxPoint;
 	std::vector<double>* weightsExclude;
+
+	// Completed steps, so a restarted search skips refitting the points it already visited
+	struct Checkpoint {
+		std::vector<double> point;
+		std::vector<double> predLogLikelihood;
+	};
+	std::vector<Checkpoint> checkpoints;
+	int pendingCheckpoints;
 };
 
 } // namespace
@@ -9,9 +9,11 @@
 #include <iomanip>
 #include <numeric>
 #include <math.h>
+#include <cmath>
 #include <cstdlib>
 #include <iterator>
 #include <algorithm>
+#include <map>
 
 #include "Types.h"
 #include "Thread.h"
@@ -85,6 +87,11 @@ MaxPoint AutoSearchCrossValidationDriver::doCrossValidationLoop(
 
 	int nDim = ccd.getHyperprior().size();
 
+	if (nDim > 1 && arguments.useBatchSearch) {
+	    return doBatchSearchLoop(ccd, selector, allArguments, nThreads, ccdPool, selectorPool,
+                              tryvalue);
+	}
+
 	std::vector<double> currentOptimal(nDim, tryvalue);
 	double currentOptimalValue;
 
@@ -162,4 +169,107 @@ MaxPoint AutoSearchCrossValidationDriver::doCrossValidationLoop(
 	return MaxPoint{currentOptimal, currentOptimalValue};
 }
 
+// Multi-dimensional search that moves all dimensions per round.  Every evaluated point is kept in
+// one joint history.  Each round fits a quadratic (log-variance) search along each dimension
+// through the current best point, using only history points that differ from it in that dimension,
+// proposes one candidate per dimension plus their joint combination, and cross-validates the whole
+// batch at once across the thread pool.  The best point in the history becomes the next center.
+MaxPoint AutoSearchCrossValidationDriver::doBatchSearchLoop(
+			CyclicCoordinateDescent& ccd,
+			AbstractSelector& selector,
+			const CCDArguments& allArguments,
+			int nThreads,
+			std::vector<CyclicCoordinateDescent*>& ccdPool,
+			std::vector<AbstractSelector*>& selectorPool,
+			double startingValue) {
+
+	const int nDim = ccd.getHyperprior().size();
+
+	typedef std::vector<double> Point;
+	std::map<Point, UniModalSearch::MS> history;
+
+	int step = 0;
+
+	auto evaluate = [&](const std::vector<Point>& batch) {
+	    std::vector<std::vector<double>> predLogLikelihoods;
+	    std::vector<double> pointEstimates = doCrossValidationBatch(ccd, selector, allArguments,
+                                                                 step, nThreads, ccdPool,
+                                                                 selectorPool, batch,
+                                                                 predLogLikelihoods);
+	    for (size_t i = 0; i < batch.size(); ++i) {
+	        double stdDevEstimate = computeStDev(predLogLikelihoods[i], pointEstimates[i]);
+	        history[batch[i]] = UniModalSearch::MS(pointEstimates[i], stdDevEstimate);
+
+	        std::ostringstream stream;
+	        stream << "AvgPred = " << pointEstimates[i] << " with stdev = " << stdDevEstimate << " at ";
+	        std::copy(batch[i].begin(), batch[i].end(), std::ostream_iterator<double>(stream, " "));
+	        logger->writeLine(stream);
+	    }
+	    step += batch.size();
+	};
+
+	Point current(nDim, startingValue);
+	evaluate(std::vector<Point>(1, current));
+
+	int round = 0;
+	while (true) {
+
+	    // Search each dimension with the others held at the current point
+	    std::vector<Point> batch;
+	    Point joint = current;
+	    int nMoved = 0;
+
+	    for (int dim = 0; dim < nDim; ++dim) {
+	        UniModalSearch searcher(10, 0.01, log(1.5));
+	        for (const auto& entry : history) {
+	            bool onAxis = true;
+	            for (int other = 0; other < nDim && onAxis; ++other) {
+	                onAxis = other == dim || entry.first[other] == current[other];
+	            }
+	            if (onAxis && !std::isnan(entry.second.m)) { // Failed fits would steer the fit away
+	                searcher.tried(entry.first[dim], entry.second.m, entry.second.s);
+	            }
+	        }
+	        StepValue next = searcher.step();
+	        Point point = current;
+	        point[dim] = next.second;
+	        if (next.first && history.find(point) == history.end()) {
+	            batch.push_back(point);
+	            joint[dim] = next.second;
+	            ++nMoved;
+	        }
+	    }
+
+	    if (batch.empty()) {
+	        break;
+	    }
+
+	    if (nMoved > 1 && history.find(joint) == history.end()) {
+	        batch.push_back(joint); // Moves all searching dimensions at once
+	    }
+
+	    std::ostringstream stream;
+	    stream << "Batch round #" << (round + 1) << " with " << batch.size() << " candidate(s)";
+	    logger->writeLine(stream);
+
+	    evaluate(batch);
+
+	    for (const auto& entry : history) {
+	        if (entry.second.m > history[current].m) {
+	            current = entry.first;
+	        }
+	    }
+
+	    ++round;
+	    if (round >= maxSteps) {
+	        std::ostringstream stream;
+	        stream << "Max steps reached!";
+	        logger->writeLine(stream);
+	        break;
+	    }
+	}
+
+	return MaxPoint{current, history[current].m};
+}
+
 } // namespace
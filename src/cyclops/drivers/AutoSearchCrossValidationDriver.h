@@ -66,6 +66,15 @@ protected:
 			std::vector<CyclicCoordinateDescent*>& ccdPool,
 			std::vector<AbstractSelector*>& selectorPool);
 
+	MaxPoint doBatchSearchLoop(
+			CyclicCoordinateDescent& ccd,
+			AbstractSelector& selector,
+			const CCDArguments& arguments,
+			int nThreads,
+			std::vector<CyclicCoordinateDescent*>& ccdPool,
+			std::vector<AbstractSelector*>& selectorPool,
+			double startingValue);
+
 // 	double doCrossValidationStep(
 // 			CyclicCoordinateDescent& ccd,
 // 			AbstractSelector& selector,
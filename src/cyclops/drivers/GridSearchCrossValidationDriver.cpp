@@ -9,6 +9,7 @@
 #include <iomanip>
 #include <numeric>
 #include <math.h>
+#include <cmath>
 #include <cstdlib>
 
 #include "GridSearchCrossValidationDriver.h"
@@ -63,6 +64,20 @@ void GridSearchCrossValidationDriver::logResults(const CCDArguments& allArgument
 
 	string sep(","); // TODO Make option
 
+	if (!jointGridPoint.empty()) {
+		const double maxValue = gridValue[findJointMax()];
+		for (size_t i = 0; i < jointGridPoint.size(); i++) {
+			outLog << std::setprecision(4) << std::fixed;
+			for (double variance : jointGridPoint[i]) {
+				outLog << std::setw(5) << variance << sep;
+			}
+			outLog << std::scientific << gridValue[i] << sep;
+			outLog << (maxValue - gridValue[i]) << std::endl;
+		}
+		outLog.close();
+		return;
+	}
+
 	double maxPoint;
 	double maxValue;
 	findMax(&maxPoint, &maxValue);
@@ -103,6 +118,10 @@ MaxPoint GridSearchCrossValidationDriver::doCrossValidationLoop(
 
     const auto& arguments = allArguments.crossValidation;
 
+	if (ccd.getHyperprior().size() > 1 && arguments.useBatchSearch) {
+		return doJointGridLoop(ccd, selector, allArguments, nThreads, ccdPool, selectorPool);
+	}
+
 // 	std::vector<double> weights;
 	for (int step = 0; step < gridSize; step++) {
 
@@ -140,6 +159,61 @@ MaxPoint GridSearchCrossValidationDriver::doCrossValidationLoop(
 }
 
 
+// Cartesian product of the one-dimensional grid over every variance; all points are
+// cross-validated in a single batch.  Only used when batch search is requested
+MaxPoint GridSearchCrossValidationDriver::doJointGridLoop(
+			CyclicCoordinateDescent& ccd,
+			AbstractSelector& selector,
+			const CCDArguments& allArguments,
+			int nThreads,
+			std::vector<CyclicCoordinateDescent*>& ccdPool,
+			std::vector<AbstractSelector*>& selectorPool) {
+
+    const auto& arguments = allArguments.crossValidation;
+	const int nDim = ccd.getHyperprior().size();
+
+	std::vector<std::vector<double>> points;
+	std::vector<int> steps(nDim, 0);
+	do {
+		std::vector<double> point;
+		for (int dim = 0; dim < nDim; ++dim) {
+			point.push_back(computeGridPoint(steps[dim]));
+		}
+		points.push_back(point);
+
+		int dim = 0;
+		while (dim < nDim && ++steps[dim] == gridSize) {
+			steps[dim++] = 0;
+		}
+		if (dim == nDim) {
+			break;
+		}
+	} while (true);
+
+	std::vector<std::vector<double>> predLogLikelihoods;
+	const std::vector<double> pointEstimates = doCrossValidationBatch(ccd, selector,
+		allArguments, 0, nThreads, ccdPool, selectorPool, points, predLogLikelihoods);
+
+	for (size_t i = 0; i < points.size(); ++i) {
+		jointGridPoint.push_back(points[i]);
+		gridValue.push_back(pointEstimates[i] /
+			(double(arguments.foldToCompute) / double(arguments.fold)));
+	}
+
+	const size_t best = findJointMax();
+	return MaxPoint{jointGridPoint[best], gridValue[best]};
+}
+
+size_t GridSearchCrossValidationDriver::findJointMax() const {
+	size_t best = 0;
+	for (size_t i = 1; i < gridValue.size(); ++i) {
+		if (gridValue[i] > gridValue[best] || std::isnan(gridValue[best])) {
+			best = i;
+		}
+	}
+	return best;
+}
+
 // void GridSearchCrossValidationDriver::drive(
 // 		CyclicCoordinateDescent& ccd,
 // 		AbstractSelector& selector,
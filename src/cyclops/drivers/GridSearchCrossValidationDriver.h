@@ -46,6 +46,14 @@ protected:
 			std::vector<CyclicCoordinateDescent*>& ccdPool,
 			std::vector<AbstractSelector*>& selectorPool);
 
+	MaxPoint doJointGridLoop(
+			CyclicCoordinateDescent& ccd,
+			AbstractSelector& selector,
+			const CCDArguments& arguments,
+			int nThreads,
+			std::vector<CyclicCoordinateDescent*>& ccdPool,
+			std::vector<AbstractSelector*>& selectorPool);
+
 // 	double doCrossValidationStep(
 // 			CyclicCoordinateDescent& ccd,
 // 			AbstractSelector& selector,
@@ -61,8 +69,11 @@ protected:
 
 	void findMax(double* maxPoint, double* maxValue);
 
+	size_t findJointMax() const;
+
 	std::vector<double> gridPoint;
 	std::vector<double> gridValue;
+	std::vector<std::vector<double>> jointGridPoint; // Filled instead of gridPoint for several variances
 
 	int gridSize;
 	double lowerLimit;
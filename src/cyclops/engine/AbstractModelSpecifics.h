@@ -12,9 +12,12 @@
 #include <cmath>
 #include <map>
 #include <cstddef>
+#include <algorithm>
 
 #include "Types.h"
 #include "ModelData.h"
+#include "Profiler.h"
+#include "Thread.h"
 
 namespace bsccs {
 
@@ -61,6 +64,11 @@ public:
 			double* iBeta,
 			const double* iY) = 0; // pure virtual
 
+	// Grows to rows and covariates appended to the data since initialize(); when incremental, the
+	// statistics are updated for the new entries only.  Returns false after falling back to a full
+	// re-initialization, in which case all lazily computed statistics must be recomputed.
+	virtual bool appendRows(int iN, int iK, int iJ, const double* beta, bool incremental) = 0; // pure virtual
+
 	//virtual void setWeights(double* inWeights, bool useCrossValidation) = 0; // pure virtual
 	virtual void setWeights(double* inWeights, double* cenWeights, bool useCrossValidation) = 0; // pure virtual
 
@@ -71,9 +79,20 @@ public:
 
 	virtual void computeNumeratorForGradient(int index, bool useWeights) = 0; // pure virtual
 
+	virtual void computeGradient(std::vector<double>& gradient, const std::vector<bool>& fixBeta, bool useWeights) = 0; // pure virtual
+
+	virtual void computeGradientAndHessianBatch(const std::vector<int>& indices, std::vector<GradientHessian>& gh, bool useWeights) = 0; // pure virtual
+
+	virtual double estimateSpectralRadius(const std::vector<bool>& fixBeta, int iterations) = 0; // pure virtual
+
+	virtual void computeHessianVectorProduct(const std::vector<double>& vector, std::vector<double>& product, bool useWeights) = 0; // pure virtual
+
 	virtual void computeFisherInformation(int indexOne, int indexTwo,
 			double *oinfo, bool useWeights) = 0; // pure virtual
 
+	virtual bool computeFisherInformationMatrix(const std::vector<int>& indices,
+			std::vector<double>& information, bool useWeights) = 0; // pure virtual
+
 	virtual void updateXBeta(double realDelta, int index, bool useWeights) = 0; // pure virtual
 
 	virtual void computeXBeta(double* beta, bool useWeights) = 0; // pure virtual
@@ -90,6 +109,9 @@ public:
 
     virtual void getPredictiveEstimates(double* y, double* weights) = 0; // pure virtual
 
+    virtual bool getBaselineHazard(std::vector<double>& time, std::vector<double>& hazard,
+                                   std::vector<int>& stratum) = 0; // pure virtual
+
     virtual double getGradientObjective(bool useCrossValidation) = 0; // pure virtual
 
     virtual void makeDirty();
@@ -115,12 +137,20 @@ public:
 
 	virtual const std::vector<double> getXBetaSave() = 0;
 
+	virtual void setXBeta(const std::vector<double>& xBeta) = 0;
+
 	virtual void saveXBeta() = 0;
 
 	virtual void zeroXBeta() = 0;
 
 	virtual void axpyXBeta(const double beta, const int j) = 0;
 
+	void setThreads(int threads) { nThreads = std::max(1, threads); }
+
+	Profiler& getProfiler() { return profiler; }
+
+	void setWorkerPool(WorkerPoolPtr pool) { workerPool = pool; }
+
 protected:
 
 //     template <class Engine>
@@ -226,6 +256,12 @@ protected:
 	// CdmPtr hXt;
 	const MmBoundType boundType;
 	std::vector<double> curvature;
+
+	int nThreads;
+
+	Profiler profiler;
+
+	WorkerPoolPtr workerPool;
 };
 
 typedef bsccs::shared_ptr<AbstractModelSpecifics> ModelSpecificsPtr;
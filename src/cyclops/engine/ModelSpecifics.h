@@ -36,6 +36,7 @@
 #include "AbstractModelSpecifics.h"
 #include "Iterators.h"
 #include "ParallelLoops.h"
+#include "Recursions.hpp"
 
 #define Fraction std::complex
 
@@ -81,12 +82,30 @@ public:
 			const std::vector<bool>& fixBeta,
 			bool useWeights);
 
+	virtual void computeGradient(
+			std::vector<double>& gradient,
+			const std::vector<bool>& fixBeta,
+			bool useWeights);
+
+	virtual void computeGradientAndHessianBatch(
+			const std::vector<int>& indices,
+			std::vector<GradientHessian>& gh,
+			bool useWeights);
+
+	virtual double estimateSpectralRadius(const std::vector<bool>& fixBeta, int iterations);
+
+	virtual void computeHessianVectorProduct(const std::vector<double>& vector, std::vector<double>& product, bool useWeights);
+
+	virtual bool computeFisherInformationMatrix(const std::vector<int>& indices, std::vector<double>& information, bool useWeights);
+
 	AbstractModelSpecifics* clone() const;
 
 	virtual const std::vector<double> getXBeta();
 
 	virtual const std::vector<double> getXBetaSave();
 
+	virtual void setXBeta(const std::vector<double>& xBeta);
+
 	virtual void saveXBeta();
 
 	virtual void zeroXBeta();
@@ -95,6 +114,8 @@ public:
 
 	virtual void computeXBeta(double* beta, bool useWeights);
 
+	virtual void makeDirty(void);
+
 	//virtual double getGradientObjective();
 
 	virtual void deviceInitialization();
@@ -116,6 +137,8 @@ public:
 	        double* iOffs,
 	        double* iBeta,
 	        const double* iY);
+
+	bool appendRows(int iN, int iK, int iJ, const double* beta, bool incremental);
 protected:
 
     const ModelData<RealType>& modelData;
@@ -160,11 +183,28 @@ protected:
     typedef std::map<int, CDCPtr> HessianSparseMap;
     HessianSparseMap hessianSparseCrossTerms;
 
+    // Exact tied-CLR scratch space, reused across coordinates
+    std::vector<HowardWorkspace<RealType>> howardWorkspaces;
+    std::vector<int> clrStrata;
+    std::vector<int> clrStart;
+    std::vector<int> clrRow;
+    RealVector clrValue;
+    RealVector clrPartial;
+
     // End of AMS move
 
 	template <typename IteratorType>
 	void axpy(RealType* y, const RealType alpha, const int index);
 
+	template <typename IteratorType>
+	RealType dot(const RealType* y, const int index);
+
+	void axpyColumn(RealType* y, const RealType alpha, const int index);
+
+	double dotColumn(const RealType* y, const int index);
+
+	void computeGradientAndHessianColumn(int index, double *ogradient, double *ohessian, bool useWeights);
+
 	void computeNumeratorForGradient(int index, bool useWeights);
 
 	void computeFisherInformation(int indexOne, int indexTwo, double *oinfo, bool useWeights);
@@ -194,6 +234,9 @@ protected:
 
 	void getPredictiveEstimates(double* y, double* weights);
 
+	bool getBaselineHazard(std::vector<double>& time, std::vector<double>& hazard,
+                           std::vector<int>& stratum);
+
 	bool allocateXjY(void);
 
 	bool allocateXjX(void);
@@ -238,6 +281,9 @@ private:
 	template <class IteratorType>
 	void computeXBetaImpl(double *beta);
 
+	template <class IteratorType>
+	void computeTiedConditionalGradientAndHessian(int index, RealType* gradient, RealType* hessian);
+
 	template <class IteratorType, class Weights>
 	void computeGradientAndHessianImpl(
 			int index,
@@ -266,6 +312,10 @@ private:
 	template <class IteratorTypeOne, class IteratorTypeTwo, class Weights>
 	void computeFisherInformationImpl(int indexOne, int indexTwo, double *oinfo, Weights w);
 
+	template <class IteratorType>
+	void computeFisherInformationMatrixImpl(const std::vector<int>& position, int size,
+	                                        std::vector<double>& information, bool useWeights);
+
 	template<class IteratorType>
 	SparseIterator<RealType> getSubjectSpecificHessianIterator(int index);
 
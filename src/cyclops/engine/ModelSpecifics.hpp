@@ -27,7 +27,6 @@
 #endif
 
 //#include "R.h"
-#include "Rcpp.h" // TODO Remove
 
 #ifdef CYCLOPS_DEBUG_TIMING
 	#include "Timing.h"
@@ -44,6 +43,9 @@
 
 	    template <typename RealType>
 	    const std::string InterceptIterator<RealType>::name = "Icp";
+
+	    template <typename RealType>
+	    const std::string InteractionIterator<RealType>::name = "Int";
 	}
 //#define OLD_WAY
 //#define NEW_WAY1
@@ -133,6 +135,12 @@ void ModelSpecifics<BaseModel,RealType>::printTiming() {
 #endif
 }
 
+template <class BaseModel, typename RealType>
+void ModelSpecifics<BaseModel,RealType>::makeDirty() {
+	AbstractModelSpecifics::makeDirty();
+	hessianSparseCrossTerms.clear(); // Cached at the previous coefficients
+}
+
 template <class BaseModel,typename RealType>
 ModelSpecifics<BaseModel,RealType>::~ModelSpecifics() {
 	// TODO Memory release here
@@ -209,6 +217,9 @@ void ModelSpecifics<BaseModel,RealType>::initializeMM(
 				case INTERCEPT :
 					incrementNormsImpl<InterceptIterator<RealType>>(j);
 					break;
+				case INTERACTION :
+					incrementNormsImpl<InteractionIterator<RealType>>(j);
+					break;
 			}
         }
     }
@@ -293,6 +304,11 @@ const std::vector<double> ModelSpecifics<BaseModel,RealType>::getXBetaSave() {
     return std::vector<double>(std::begin(hXBetaSave), std::end(hXBetaSave));
 }
 
+template <class BaseModel,typename RealType>
+void ModelSpecifics<BaseModel,RealType>::setXBeta(const std::vector<double>& xBeta) {
+	std::copy(std::begin(xBeta), std::end(xBeta), std::begin(hXBeta));
+}
+
 template <class BaseModel,typename RealType>
 void ModelSpecifics<BaseModel,RealType>::zeroXBeta() {
 	std::fill(std::begin(hXBeta), std::end(hXBeta), 0.0);
@@ -311,6 +327,15 @@ void ModelSpecifics<BaseModel,RealType>::saveXBeta() {
 
 template <class BaseModel,typename RealType>
 void ModelSpecifics<BaseModel,RealType>::computeXBeta(double* beta, bool useWeights) {
+    ScopedTimer timer(profiler, ProfilePhase::COMPUTE_XBETA);
+
+    if (hX.isOutOfCore()) { // Column by column; the transpose would hold all of X in memory
+        zeroXBeta();
+        for (size_t j = 0; j < J; ++j) {
+            axpyXBeta(beta[j], j);
+        }
+        return;
+    }
 
     if (!hXt) {
         initializeMmXt();
@@ -332,6 +357,8 @@ void ModelSpecifics<BaseModel,RealType>::computeXBeta(double* beta, bool useWeig
         break;
     case INTERCEPT:
         break;
+    case INTERACTION: // transpose() materializes interaction products as SPARSE rows
+        break;
 }
 
 
@@ -390,6 +417,54 @@ void ModelSpecifics<BaseModel,RealType>::axpy(RealType* y, const RealType alpha,
 	}
 }
 
+template <class BaseModel,typename RealType> template <class IteratorType>
+RealType ModelSpecifics<BaseModel,RealType>::dot(const RealType* y, const int index) {
+	RealType sum = static_cast<RealType>(0);
+	IteratorType it(hX, index);
+	for (; it; ++it) {
+		sum += y[it.index()] * it.value();
+	}
+	return sum;
+}
+
+template <class BaseModel,typename RealType>
+void ModelSpecifics<BaseModel,RealType>::axpyColumn(RealType* y, const RealType alpha, const int index) {
+    switch (hX.getFormatType(index)) {
+    case INDICATOR :
+        axpy<IndicatorIterator<RealType>>(y, alpha, index);
+        break;
+    case SPARSE :
+        axpy<SparseIterator<RealType>>(y, alpha, index);
+        break;
+    case DENSE :
+        axpy<DenseIterator<RealType>>(y, alpha, index);
+        break;
+    case INTERCEPT :
+        axpy<InterceptIterator<RealType>>(y, alpha, index);
+        break;
+    case INTERACTION :
+        axpy<InteractionIterator<RealType>>(y, alpha, index);
+        break;
+    }
+}
+
+template <class BaseModel,typename RealType>
+double ModelSpecifics<BaseModel,RealType>::dotColumn(const RealType* y, const int index) {
+    switch (hX.getFormatType(index)) {
+    case INDICATOR :
+        return dot<IndicatorIterator<RealType>>(y, index);
+    case SPARSE :
+        return dot<SparseIterator<RealType>>(y, index);
+    case DENSE :
+        return dot<DenseIterator<RealType>>(y, index);
+    case INTERCEPT :
+        return dot<InterceptIterator<RealType>>(y, index);
+    case INTERACTION :
+        return dot<InteractionIterator<RealType>>(y, index);
+    }
+    return 0.0;
+}
+
 template <class BaseModel,typename RealType>
 void ModelSpecifics<BaseModel,RealType>::axpyXBeta(const double beta, const int j) {
 
@@ -405,6 +480,9 @@ void ModelSpecifics<BaseModel,RealType>::axpyXBeta(const double beta, const int
 		case INTERCEPT:
 		    axpy < InterceptIterator<RealType> > (hXBeta.data(), beta, j);
 		    break;
+		case INTERACTION:
+		    axpy < InteractionIterator<RealType> > (hXBeta.data(), beta, j);
+		    break;
 		case DENSE:
 			axpy < DenseIterator<RealType> > (hXBeta.data(), beta, j);
 			break;
@@ -426,6 +504,8 @@ void ModelSpecifics<BaseModel,RealType>::axpyXBeta(const double beta, const int
 // ESK: Added cWeights (censoring weights) as an input
 template <class BaseModel,typename RealType>
 void ModelSpecifics<BaseModel,RealType>::setWeights(double* inWeights, double *cenWeights, bool useCrossValidation) {
+	ScopedTimer timer(profiler, ProfilePhase::SET_WEIGHTS);
+
 	// Set K weights
 	if (hKWeight.size() != K) {
 		hKWeight.resize(K);
@@ -605,6 +685,8 @@ void ModelSpecifics<BaseModel,RealType>::computeFixedTermsInGradientAndHessian(b
 template <class BaseModel,typename RealType>
 double ModelSpecifics<BaseModel,RealType>::getLogLikelihood(bool useCrossValidation) {
 
+	ScopedTimer timer(profiler, ProfilePhase::LOG_LIKELIHOOD);
+
 #ifdef CYCLOPS_DEBUG_TIMING
 	auto start = bsccs::chrono::steady_clock::now();
 #endif
@@ -706,21 +788,64 @@ void ModelSpecifics<BaseModel,RealType>::getPredictiveEstimates(double* y, doubl
 	// TODO How to remove code duplication above?
 }
 
-// TODO The following function is an example of a double-dispatch, rewrite without need for virtual function
 template <class BaseModel,typename RealType>
-void ModelSpecifics<BaseModel,RealType>::computeGradientAndHessian(int index, double *ogradient,
-		double *ohessian, bool useWeights) {
+bool ModelSpecifics<BaseModel,RealType>::getBaselineHazard(std::vector<double>& time,
+                                                           std::vector<double>& hazard,
+                                                           std::vector<int>& stratum) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifndef CYCLOPS_DEBUG_TIMING_LOW
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
-#endif
+    if (!(BaseModel::likelihoodHasDenominator && BaseModel::cumulativeGradientAndHessian)) {
+        return false;
+    }
 
-	if (hX.getNumberOfNonZeroEntries(index) == 0) {
-	    *ogradient = 0.0; *ohessian = 0.0;
-	    return;
-	}
+    time.clear();
+    hazard.clear();
+    stratum.clear();
+
+    // Rows are sorted by decreasing time within strata and tied failures share a pid,
+    // so accDenomPid[i] is the risk-set total at the time of pid i and hNWeight[i]
+    // its (weighted) number of failures. Walk each stratum backwards to accumulate
+    // Breslow increments in increasing time.
+    size_t begin = 0;
+    while (begin < K) {
+        const int currentStratum = hPidOriginal[begin];
+        size_t end = begin;
+        while (end < K && hPidOriginal[end] == currentStratum) {
+            ++end;
+        }
+
+        double cumulativeHazard = 0.0;
+        int lastPid = -1;
+        size_t first = time.size();
+        for (size_t k = end; k > begin; --k) {
+            const int i = hPid[k - 1];
+            if (i < 0 || static_cast<size_t>(i) >= N) {
+                continue; // Excluded by weights
+            }
+
+            if (i != lastPid && hNWeight[i] > static_cast<RealType>(0)) {
+                cumulativeHazard += static_cast<double>(hNWeight[i] / accDenomPid[i]);
+            }
+            lastPid = i;
+
+            const double t = static_cast<double>(hOffs[k - 1]);
+            if (time.size() == first || time.back() != t) {
+                time.push_back(t);
+                hazard.push_back(cumulativeHazard);
+                stratum.push_back(currentStratum);
+            } else {
+                hazard.back() = cumulativeHazard;
+            }
+        }
+        begin = end;
+    }
+
+    return true;
+}
+
+// TODO The following function is an example of a double-dispatch, rewrite without need for virtual function
+template <class BaseModel,typename RealType>
+void ModelSpecifics<BaseModel,RealType>::computeGradientAndHessianColumn(int index, double *ogradient,
+		double *ohessian, bool useWeights) {
 
 	// Run-time dispatch, so virtual call should not effect speed
 	if (useWeights) {
@@ -737,6 +862,9 @@ void ModelSpecifics<BaseModel,RealType>::computeGradientAndHessian(int index, do
 			case INTERCEPT :
 				computeGradientAndHessianImpl<InterceptIterator<RealType>>(index, ogradient, ohessian, weighted);
 				break;
+			case INTERACTION :
+				computeGradientAndHessianImpl<InteractionIterator<RealType>>(index, ogradient, ohessian, weighted);
+				break;
 		}
 	} else {
 		switch (hX.getFormatType(index)) {
@@ -752,8 +880,31 @@ void ModelSpecifics<BaseModel,RealType>::computeGradientAndHessian(int index, do
 			case INTERCEPT :
 				computeGradientAndHessianImpl<InterceptIterator<RealType>>(index, ogradient, ohessian, unweighted);
 				break;
+			case INTERACTION :
+				computeGradientAndHessianImpl<InteractionIterator<RealType>>(index, ogradient, ohessian, unweighted);
+				break;
 		}
 	}
+}
+
+template <class BaseModel,typename RealType>
+void ModelSpecifics<BaseModel,RealType>::computeGradientAndHessian(int index, double *ogradient,
+		double *ohessian, bool useWeights) {
+
+	ScopedTimer timer(profiler, ProfilePhase::GRADIENT_HESSIAN, hX.getFormatType(index));
+
+#ifdef CYCLOPS_DEBUG_TIMING
+#ifndef CYCLOPS_DEBUG_TIMING_LOW
+	auto start = bsccs::chrono::steady_clock::now();
+#endif
+#endif
+
+	if (hX.getNumberOfNonZeroEntries(index) == 0) {
+	    *ogradient = 0.0; *ohessian = 0.0;
+	    return;
+	}
+
+	computeGradientAndHessianColumn(index, ogradient, ohessian, useWeights);
 
 #ifdef CYCLOPS_DEBUG_TIMING
 #ifndef CYCLOPS_DEBUG_TIMING_LOW
@@ -779,6 +930,8 @@ void ModelSpecifics<BaseModel,RealType>::computeMMGradientAndHessian(
         const std::vector<bool>& fixBeta,
         bool useWeights) {
 
+    ScopedTimer timer(profiler, ProfilePhase::MM_GRADIENT_HESSIAN);
+
     if (norm.size() == 0) {
         initializeMM(boundType, fixBeta);
     }
@@ -812,6 +965,9 @@ void ModelSpecifics<BaseModel,RealType>::computeMMGradientAndHessian(
             case INTERCEPT :
                 computeMMGradientAndHessianImpl<InterceptIterator<RealType>>(index, ogradient, ohessian, weighted);
                 break;
+            case INTERACTION :
+                computeMMGradientAndHessianImpl<InteractionIterator<RealType>>(index, ogradient, ohessian, weighted);
+                break;
             }
         } else {
             switch (hX.getFormatType(index)) {
@@ -827,6 +983,9 @@ void ModelSpecifics<BaseModel,RealType>::computeMMGradientAndHessian(
             case INTERCEPT :
                 computeMMGradientAndHessianImpl<InterceptIterator<RealType>>(index, ogradient, ohessian, unweighted);
                 break;
+            case INTERACTION :
+                computeMMGradientAndHessianImpl<InteractionIterator<RealType>>(index, ogradient, ohessian, unweighted);
+                break;
             }
         }
         }
@@ -842,6 +1001,342 @@ void ModelSpecifics<BaseModel,RealType>::computeMMGradientAndHessian(
 
 }
 
+template <class BaseModel,typename RealType>
+void ModelSpecifics<BaseModel,RealType>::computeGradient(
+        std::vector<double>& gradient,
+        const std::vector<bool>& fixBeta,
+        bool useWeights) {
+
+    gradient.resize(J);
+
+    if (!BaseModel::hasIndependentRows) {
+        // Grouped and ordered kernels share the numerator scratch vectors; one column at a time
+        for (int index = 0; index < J; ++index) {
+            double hessian;
+            if (fixBeta[index]) {
+                gradient[index] = 0.0;
+            } else {
+                computeNumeratorForGradient(index, useWeights);
+                computeGradientAndHessian(index, &gradient[index], &hessian, useWeights);
+            }
+        }
+        return;
+    }
+
+    ScopedTimer timer(profiler, ProfilePhase::GRADIENT_HESSIAN);
+
+    // Independent-row kernels only read the sufficient statistics, so columns run in parallel
+    auto func = [this,&gradient,&fixBeta,useWeights](int chunk, int begin, int end) {
+        for (int index = begin; index < end; ++index) {
+            double hessian;
+            if (fixBeta[index] || hX.getNumberOfNonZeroEntries(index) == 0) {
+                gradient[index] = 0.0;
+            } else {
+                computeGradientAndHessianColumn(index, &gradient[index], &hessian, useWeights);
+            }
+        }
+    };
+
+    C11Threads info(nThreads, 16, workerPool.get());
+    variants::for_each_chunk(0, J, func, info);
+}
+
+template <class BaseModel,typename RealType>
+void ModelSpecifics<BaseModel,RealType>::computeGradientAndHessianBatch(
+        const std::vector<int>& indices,
+        std::vector<GradientHessian>& gh,
+        bool useWeights) {
+
+    const int size = indices.size();
+    gh.resize(size);
+
+    if (!BaseModel::hasIndependentRows) {
+        for (int i = 0; i < size; ++i) {
+            computeNumeratorForGradient(indices[i], useWeights);
+            computeGradientAndHessian(indices[i], &gh[i].first, &gh[i].second, useWeights);
+        }
+        return;
+    }
+
+    ScopedTimer timer(profiler, ProfilePhase::GRADIENT_HESSIAN);
+
+    auto func = [this,&indices,&gh,useWeights](int chunk, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const int index = indices[i];
+            if (hX.getNumberOfNonZeroEntries(index) == 0) {
+                gh[i].first = 0.0; gh[i].second = 0.0;
+            } else {
+                computeGradientAndHessianColumn(index, &gh[i].first, &gh[i].second, useWeights);
+            }
+        }
+    };
+
+    C11Threads info(nThreads, 2, workerPool.get());
+    variants::for_each_chunk(0, size, func, info);
+}
+
+template <class BaseModel,typename RealType>
+double ModelSpecifics<BaseModel,RealType>::estimateSpectralRadius(const std::vector<bool>& fixBeta,
+                                                                  int iterations) {
+
+    // Power iteration on the Gram matrix of the free columns scaled to unit length
+    std::vector<double> scale(J, 0.0);
+    RealVector column(K, static_cast<RealType>(0));
+    for (int j = 0; j < J; ++j) {
+        if (!fixBeta[j] && hX.getNumberOfNonZeroEntries(j) > 0) {
+            axpyColumn(column.data(), static_cast<RealType>(1), j);
+            const double squaredNorm = dotColumn(column.data(), j);
+            axpyColumn(column.data(), static_cast<RealType>(-1), j); // Exactly back to zero
+            if (squaredNorm > 0.0) {
+                scale[j] = 1.0 / std::sqrt(squaredNorm);
+            }
+        }
+    }
+
+    std::vector<double> v(J);
+    for (int j = 0; j < J; ++j) {
+        v[j] = (scale[j] > 0.0) ? 1.0 + 0.01 * (j % 7) : 0.0; // Avoid starting orthogonal to the top eigenvector
+    }
+
+    RealVector w(K);
+    double radius = 0.0;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        double norm = 0.0;
+        for (int j = 0; j < J; ++j) {
+            norm += v[j] * v[j];
+        }
+        norm = std::sqrt(norm);
+        if (norm == 0.0) {
+            return 0.0;
+        }
+
+        std::fill(w.begin(), w.end(), static_cast<RealType>(0));
+        for (int j = 0; j < J; ++j) {
+            if (v[j] != 0.0) {
+                axpyColumn(w.data(), static_cast<RealType>(v[j] * scale[j] / norm), j);
+            }
+        }
+        radius = 0.0;
+        for (int j = 0; j < J; ++j) {
+            if (scale[j] > 0.0) {
+                v[j] = scale[j] * dotColumn(w.data(), j);
+                radius += v[j] * v[j];
+            }
+        }
+        radius = std::sqrt(radius); // ||G u|| for unit u, converging to the largest eigenvalue
+    }
+    return radius;
+}
+
+template <class BaseModel,typename RealType>
+void ModelSpecifics<BaseModel,RealType>::computeHessianVectorProduct(
+        const std::vector<double>& vector,
+        std::vector<double>& product,
+        bool useWeights) {
+
+    product.assign(J, 0.0);
+    if (!BaseModel::hasIndependentRows) {
+        return; // Cross-row terms are not captured by a diagonal row curvature
+    }
+
+    ScopedTimer timer(profiler, ProfilePhase::GRADIENT_HESSIAN);
+
+    // First product: u = X v
+    RealVector u(K, static_cast<RealType>(0));
+    for (int j = 0; j < J; ++j) {
+        if (vector[j] != 0.0) {
+            axpyColumn(u.data(), static_cast<RealType>(vector[j]), j);
+        }
+    }
+
+    // Scale by the per-row Fisher weight, which is the observed curvature for independent rows;
+    // row weights enter exactly when they enter computeGradient()
+    struct UnitValue {
+        RealType value() const { return static_cast<RealType>(1); }
+    } unit;
+    for (int k = 0; k < K; ++k) {
+        RealType curvature = static_cast<RealType>(0);
+        if (useWeights) {
+            BaseModel::incrementFisherInformation(unit, weighted, &curvature,
+                    offsExpXBeta[k], 0.0, 0.0, denomPid[BaseModel::getGroup(hPid, k)],
+                    hKWeight[k], static_cast<RealType>(1), hXBeta[k], hY[k]);
+        } else {
+            BaseModel::incrementFisherInformation(unit, unweighted, &curvature,
+                    offsExpXBeta[k], 0.0, 0.0, denomPid[BaseModel::getGroup(hPid, k)],
+                    static_cast<RealType>(1), static_cast<RealType>(1), hXBeta[k], hY[k]);
+        }
+        u[k] *= curvature;
+    }
+
+    // Second product: X' W u, columns in parallel
+    auto func = [this,&u,&product](int chunk, int begin, int end) {
+        for (int index = begin; index < end; ++index) {
+            product[index] = -dotColumn(u.data(), index);
+        }
+    };
+
+    C11Threads info(nThreads, 16, workerPool.get());
+    variants::for_each_chunk(0, J, func, info);
+}
+
+template <class BaseModel,typename RealType>
+bool ModelSpecifics<BaseModel,RealType>::computeFisherInformationMatrix(
+        const std::vector<int>& indices,
+        std::vector<double>& information,
+        bool useWeights) {
+
+    const int size = indices.size();
+    information.assign(size * size, 0.0);
+
+    if (BaseModel::cumulativeGradientAndHessian || BaseModel::exactTies || BaseModel::exactCLR) {
+        return false; // Risk-set and exact-conditional terms do not decompose by stratum
+    }
+    if (!BaseModel::hasIndependentRows && useWeights) {
+        return false; // Weighted strata change the denominators
+    }
+    if (hX.isOutOfCore()) {
+        return false; // The row sweep needs the transpose of all of X in memory
+    }
+
+    if (!hXt) {
+        initializeMmXt();
+    }
+
+    std::vector<int> position(J, -1);
+    for (int i = 0; i < size; ++i) {
+        position[indices[i]] = i;
+    }
+
+    ScopedTimer timer(profiler, ProfilePhase::GRADIENT_HESSIAN);
+
+    switch(hXt->getFormatType(0)) {
+    case INDICATOR :
+        computeFisherInformationMatrixImpl<IndicatorIterator<RealType>>(position, size, information, useWeights);
+        break;
+    case SPARSE :
+        computeFisherInformationMatrixImpl<SparseIterator<RealType>>(position, size, information, useWeights);
+        break;
+    case DENSE :
+        computeFisherInformationMatrixImpl<DenseIterator<RealType>>(position, size, information, useWeights);
+        break;
+    case INTERCEPT:
+        break;
+    case INTERACTION: // transpose() materializes interaction products as SPARSE rows
+        break;
+    }
+    return true;
+}
+
+template <class BaseModel,typename RealType> template <class IteratorType>
+void ModelSpecifics<BaseModel,RealType>::computeFisherInformationMatrixImpl(
+        const std::vector<int>& position, int size,
+        std::vector<double>& information, bool useWeights) {
+
+    // One pass over the rows of X (strata for grouped models), each chunk into its own accumulator:
+    // independent rows add w_k x_k x_k'; a stratum s adds N_s (sum_k p_k x_k x_k' - m_s m_s'),
+    // with p_k = offsExpXBeta_k / denom_s and m_s = sum_k p_k x_k
+    const int nBlocks = BaseModel::hasIndependentRows ? K : N;
+    const int nChunks = std::max(1, std::min(nThreads, nBlocks));
+    std::vector<double> partial(static_cast<size_t>(nChunks) * size * size, 0.0);
+
+    struct UnitValue {
+        RealType value() const { return static_cast<RealType>(1); }
+    } unit;
+
+    auto func = [this,&position,size,&partial,&unit,useWeights](int chunk, int begin, int end) {
+
+        double* accumulator = partial.data() + static_cast<size_t>(chunk) * size * size;
+        std::vector<int> entryIndex;
+        std::vector<double> entryValue;
+        std::vector<double> mean(size, 0.0);
+        std::vector<char> seen(size, 0);
+        std::vector<int> touched;
+
+        auto gatherRow = [this,&position,&entryIndex,&entryValue](int k) {
+            entryIndex.clear();
+            entryValue.clear();
+            for (IteratorType it(*hXt, k); it; ++it) {
+                const int a = position[it.index()];
+                if (a >= 0 && it.value() != static_cast<RealType>(0)) {
+                    entryIndex.push_back(a);
+                    entryValue.push_back(it.value());
+                }
+            }
+        };
+
+        auto addOuterProduct = [&entryIndex,&entryValue,accumulator,size](double scale) {
+            const int length = entryIndex.size();
+            for (int p = 0; p < length; ++p) {
+                const double scaled = scale * entryValue[p];
+                double* row = accumulator + static_cast<size_t>(entryIndex[p]) * size;
+                for (int q = 0; q < length; ++q) {
+                    row[entryIndex[q]] += scaled * entryValue[q];
+                }
+            }
+        };
+
+        for (int block = begin; block < end; ++block) {
+            if (BaseModel::hasIndependentRows) {
+                const int k = block;
+                RealType curvature = static_cast<RealType>(0);
+                if (useWeights) {
+                    BaseModel::incrementFisherInformation(unit, weighted, &curvature,
+                            offsExpXBeta[k], 0.0, 0.0, denomPid[BaseModel::getGroup(hPid, k)],
+                            hKWeight[k], static_cast<RealType>(1), hXBeta[k], hY[k]);
+                } else {
+                    BaseModel::incrementFisherInformation(unit, unweighted, &curvature,
+                            offsExpXBeta[k], 0.0, 0.0, denomPid[BaseModel::getGroup(hPid, k)],
+                            static_cast<RealType>(1), static_cast<RealType>(1), hXBeta[k], hY[k]);
+                }
+                if (curvature != static_cast<RealType>(0)) {
+                    gatherRow(k);
+                    addOuterProduct(curvature);
+                }
+            } else {
+                const int group = BaseModel::getGroup(hPid, hNtoK[block]);
+                const double nEvents = hNWeight[group];
+                if (nEvents == 0.0) continue;
+                const double denom = denomPid[group];
+
+                for (int k = hNtoK[block]; k < hNtoK[block + 1]; ++k) {
+                    const double p = offsExpXBeta[k] / denom;
+                    gatherRow(k);
+                    addOuterProduct(nEvents * p);
+                    for (size_t e = 0; e < entryIndex.size(); ++e) {
+                        if (!seen[entryIndex[e]]) {
+                            seen[entryIndex[e]] = 1;
+                            touched.push_back(entryIndex[e]);
+                        }
+                        mean[entryIndex[e]] += p * entryValue[e];
+                    }
+                }
+
+                for (int a : touched) {
+                    double* row = accumulator + static_cast<size_t>(a) * size;
+                    for (int b : touched) {
+                        row[b] -= nEvents * mean[a] * mean[b];
+                    }
+                }
+                for (int a : touched) {
+                    mean[a] = 0.0;
+                    seen[a] = 0;
+                }
+                touched.clear();
+            }
+        }
+    };
+
+    C11Threads info(nChunks, 1, workerPool.get());
+    variants::for_each_chunk(0, nBlocks, func, info);
+
+    for (int chunk = 0; chunk < nChunks; ++chunk) {
+        const double* accumulator = partial.data() + static_cast<size_t>(chunk) * size * size;
+        for (size_t i = 0; i < information.size(); ++i) {
+            information[i] += accumulator[i];
+        }
+    }
+}
+
 template <class BaseModel,typename RealType> template <class IteratorType, class Weights>
 void ModelSpecifics<BaseModel,RealType>::computeMMGradientAndHessianImpl(int index, double *ogradient,
                                                                            double *ohessian, Weights w) {
@@ -888,6 +1383,81 @@ void ModelSpecifics<BaseModel,RealType>::computeMMGradientAndHessianImpl(int ind
 #endif
 }
 
+template <class BaseModel,typename RealType> template <class IteratorType>
+void ModelSpecifics<BaseModel,RealType>::computeTiedConditionalGradientAndHessian(int index,
+        RealType* gradient, RealType* hessian) {
+
+    // Gather the column by stratum in one sweep; strata without entries in this column
+    // (or without cases) contribute nothing and are skipped
+    clrStrata.clear();
+    clrStart.clear();
+    clrRow.clear();
+    clrValue.clear();
+
+    int stratum = -1;
+    for (IteratorType it(hX, index); it; ++it) {
+        const int k = it.index();
+        if (stratum < 0 || k >= hNtoK[stratum + 1]) {
+            stratum = std::upper_bound(hNtoK.begin(), hNtoK.begin() + N + 1, k) - hNtoK.begin() - 1;
+            if (hNWeight[stratum] > static_cast<RealType>(0)) {
+                clrStrata.push_back(stratum);
+                clrStart.push_back(clrRow.size());
+            }
+        }
+        if (!clrStrata.empty() && clrStrata.back() == stratum && it.value() != static_cast<RealType>(0)) {
+            clrRow.push_back(k - hNtoK[stratum]);
+            clrValue.push_back(it.value());
+        }
+    }
+    clrStart.push_back(clrRow.size());
+
+    const int nStrata = clrStrata.size();
+    const int nChunks = std::max(1, std::min(nThreads, nStrata));
+
+    if (howardWorkspaces.size() < static_cast<size_t>(nChunks)) {
+        howardWorkspaces.resize(nChunks);
+    }
+    clrPartial.assign(2 * nChunks, static_cast<RealType>(0));
+
+    auto func = [this](int chunk, int begin, int end) {
+
+        auto& workspace = howardWorkspaces[chunk];
+        RealType g = static_cast<RealType>(0);
+        RealType h = static_cast<RealType>(0);
+
+        for (int s = begin; s < end; ++s) {
+            if (clrStart[s] == clrStart[s + 1]) continue; // All-zero within stratum
+
+            const int i = clrStrata[s];
+            const int numSubjects = hNtoK[i + 1] - hNtoK[i];
+            const int numCases = hNWeight[i];
+
+            workspace.reserve(numSubjects, numCases);
+            std::fill(workspace.x.begin(), workspace.x.begin() + numSubjects, static_cast<RealType>(0));
+            for (int entry = clrStart[s]; entry < clrStart[s + 1]; ++entry) {
+                workspace.x[clrRow[entry]] = clrValue[entry];
+            }
+
+            RealType firstRatio, secondRatio;
+            computeScaledHowardRecursion(hXBeta.begin() + hNtoK[i], workspace.x.data(),
+                                         numSubjects, numCases, workspace, &firstRatio, &secondRatio);
+
+            g += firstRatio;
+            h += secondRatio - firstRatio * firstRatio;
+        }
+        clrPartial[2 * chunk] = g;
+        clrPartial[2 * chunk + 1] = h;
+    };
+
+    C11Threads info(nChunks, 1, workerPool.get());
+    variants::for_each_chunk(0, nStrata, func, info);
+
+    for (int chunk = 0; chunk < nChunks; ++chunk) {
+        *gradient += clrPartial[2 * chunk];
+        *hessian += clrPartial[2 * chunk + 1];
+    }
+}
+
 template <class BaseModel,typename RealType> template <class IteratorType, class Weights>
 void ModelSpecifics<BaseModel,RealType>::computeGradientAndHessianImpl(int index, double *ogradient,
 		double *ohessian, Weights w) {
@@ -1038,65 +1608,8 @@ void ModelSpecifics<BaseModel,RealType>::computeGradientAndHessianImpl(int index
 	    }
 
 	} else if (BaseModel::exactCLR) {
-	    //tbb::mutex mutex0;
-
-#ifdef USE_RCPP_PARALLEL
 
-	    tbb::combinable<RealType> newGrad(static_cast<RealType>(0));
-	    tbb::combinable<RealType> newHess(static_cast<RealType>(0));
-
-	    auto func = [&,index](const tbb::blocked_range<int>& range){
-
-	        using std::isinf;
-
-	        for (int i = range.begin(); i < range.end(); ++i) {
-	            DenseView<IteratorType, RealType> x(IteratorType(hX, index), hNtoK[i], hNtoK[i+1]);
-	            int numSubjects = hNtoK[i+1] - hNtoK[i];
-	            int numCases = hNWeight[i];
-	            std::vector<RealType> value = computeHowardRecursion<RealType>(offsExpXBeta.begin() + hNtoK[i], x, numSubjects, numCases);
-	            if (value[0]==0 || value[1] == 0 || value[2] == 0 || isinf(value[0]) || isinf(value[1]) || isinf(value[2])) {
-	                DenseView<IteratorType, RealType> newX(IteratorType(hX, index), hNtoK[i], hNtoK[i+1]);
-	                std::vector<DDouble> value = computeHowardRecursion<DDouble>(offsExpXBeta.begin() + hNtoK[i], newX, numSubjects, numCases);//, threadPool);//, hY.begin() + hNtoK[i]);
-	                using namespace sugar;
-	                //mutex0.lock();
-	                newGrad.local() -= (RealType)(-value[1]/value[0]);
-	                newHess.local() -= (RealType)((value[1]/value[0]) * (value[1]/value[0]) - value[2]/value[0]);
-	                //mutex0.unlock();
-	                continue;
-	            }
-	            //mutex0.lock();
-	            newGrad.local() -= (RealType)(-value[1]/value[0]);
-	            newHess.local() -= (RealType)((value[1]/value[0]) * (value[1]/value[0]) - value[2]/value[0]);
-	            //mutex0.unlock();
-	        }
-	    };
-	    tbb::parallel_for(tbb::blocked_range<int>(0,N),func);
-	    gradient += newGrad.combine([](const RealType& x, const RealType& y) {return x+y;});
-	    hessian += newHess.combine([](const RealType& x, const RealType& y) {return x+y;});
-#else
-
-	    using std::isinf;
-
-	    for (int i=0; i<N; i++) {
-	    DenseView<IteratorType, RealType> x(IteratorType(hX, index), hNtoK[i], hNtoK[i+1]);
-	    int numSubjects = hNtoK[i+1] - hNtoK[i];
-	    int numCases = hNWeight[i];
-
-	    std::vector<RealType> value = computeHowardRecursion<RealType>(offsExpXBeta.begin() + hNtoK[i], x, numSubjects, numCases);//, threadPool);//, hY.begin() + hNtoK[i]);
-	    //std::cout<<" values" << i <<": "<<value[0]<<" | "<<value[1]<<" | "<<value[2];
-	    if (value[0]==0 || value[1] == 0 || value[2] == 0 || isinf(value[0]) || isinf(value[1]) || isinf(value[2])) {
-	    DenseView<IteratorType, RealType> newX(IteratorType(hX, index), hNtoK[i], hNtoK[i+1]);
-	    std::vector<DDouble> value = computeHowardRecursion<DDouble>(offsExpXBeta.begin() + hNtoK[i], newX, numSubjects, numCases);//, threadPool);//, hY.begin() + hNtoK[i]);
-	    using namespace sugar;
-	    gradient -= (RealType)(-value[1]/value[0]);
-	    hessian -= (RealType)((value[1]/value[0]) * (value[1]/value[0]) - value[2]/value[0]);
-	    continue;
-	    }
-	    //gradient -= (RealType)(value[3] - value[1]/value[0]);
-	    gradient -= (RealType)(-value[1]/value[0]);
-	    hessian -= (RealType)((value[1]/value[0]) * (value[1]/value[0]) - value[2]/value[0]);
-	    }
-#endif // USE_RCPP_PARALLEL
+	    computeTiedConditionalGradientAndHessian<IteratorType>(index, &gradient, &hessian);
 
 	} else {
 
@@ -1220,6 +1733,9 @@ void ModelSpecifics<BaseModel,RealType>::computeFisherInformation(int indexOne,
 			case INTERCEPT :
 				dispatchFisherInformation<InterceptIterator<RealType>>(indexOne, indexTwo, oinfo, weighted);
 				break;
+			case INTERACTION :
+				dispatchFisherInformation<InteractionIterator<RealType>>(indexOne, indexTwo, oinfo, weighted);
+				break;
 		}
 	}
 }
@@ -1239,6 +1755,9 @@ void ModelSpecifics<BaseModel,RealType>::dispatchFisherInformation(int indexOne,
 		case INTERCEPT :
 			computeFisherInformationImpl<IteratorTypeOne,InterceptIterator<RealType>>(indexOne, indexTwo, oinfo, w);
 			break;
+		case INTERACTION :
+			computeFisherInformationImpl<IteratorTypeOne,InteractionIterator<RealType>>(indexOne, indexTwo, oinfo, w);
+			break;
 	}
 //	std::cerr << "End of dispatch" << std::endl;
 }
@@ -1353,6 +1872,8 @@ void ModelSpecifics<BaseModel,RealType>::computeFisherInformationImpl(int indexO
 template <class BaseModel,typename RealType>
 void ModelSpecifics<BaseModel,RealType>::computeNumeratorForGradient(int index, bool useWeights) {
 
+	ScopedTimer timer(profiler, ProfilePhase::NUMERATOR_FOR_GRADIENT, hX.getFormatType(index));
+
 #ifdef CYCLOPS_DEBUG_TIMING
 #ifndef CYCLOPS_DEBUG_TIMING_LOW
 	auto start = bsccs::chrono::steady_clock::now();
@@ -1412,6 +1933,21 @@ void ModelSpecifics<BaseModel,RealType>::computeNumeratorForGradient(int index,
 				}
 				break;
 		}
+		case INTERACTION : {
+				SparseIterator<RealType> itS(*(sparseIndices)[index]);
+				for (; itS; ++itS) { // Only affected entries
+					numerPid[itS.index()] = static_cast<RealType>(0.0);
+					if (BaseModel::hasTwoNumeratorTerms) { // Compile-time switch
+						numerPid2[itS.index()] = static_cast<RealType>(0.0);
+					}
+				}
+				if (useWeights) {
+				    incrementNumeratorForGradientImpl<InteractionIterator<RealType>, WeightedOperation>(index);
+				} else {
+				    incrementNumeratorForGradientImpl<InteractionIterator<RealType>, UnweightedOperation>(index);
+				}
+				break;
+		}
 		default : break;
 		}
 	}
@@ -1466,6 +2002,8 @@ void ModelSpecifics<BaseModel,RealType>::incrementNumeratorForGradientImpl(int i
 template <class BaseModel,typename RealType>
 void ModelSpecifics<BaseModel,RealType>::updateXBeta(double delta, int index, bool useWeights) {
 
+	ScopedTimer timer(profiler, ProfilePhase::UPDATE_XBETA, hX.getFormatType(index));
+
 #ifdef CYCLOPS_DEBUG_TIMING
 #ifndef CYCLOPS_DEBUG_TIMING_LOW
 	auto start = bsccs::chrono::steady_clock::now();
@@ -1507,6 +2045,14 @@ void ModelSpecifics<BaseModel,RealType>::updateXBeta(double delta, int index, bo
 	            updateXBetaImpl<InterceptIterator<RealType>, UnweightedOperation>(realDelta, index);
 	        }
 			break;
+	    }
+	    case INTERACTION : {
+	        if (useWeights) {
+			    updateXBetaImpl<InteractionIterator<RealType>, WeightedOperation>(realDelta, index);
+	        } else {
+	            updateXBetaImpl<InteractionIterator<RealType>, UnweightedOperation>(realDelta, index);
+	        }
+			break;
 	    }
 		default : break;
 	}
@@ -1614,6 +2160,8 @@ void ModelSpecifics<BaseModel,RealType>::computeRemainingStatisticsImpl() {
 template <class BaseModel,typename RealType>
 void ModelSpecifics<BaseModel,RealType>::computeRemainingStatistics(bool useWeights) {
 
+	ScopedTimer timer(profiler, ProfilePhase::REMAINING_STATISTICS);
+
 #ifdef CYCLOPS_DEBUG_TIMING
 	auto start = bsccs::chrono::steady_clock::now();
 #endif
@@ -1874,6 +2422,18 @@ void ModelSpecifics<BaseModel,RealType>::setupSparseIndices(const int max) {
     for (size_t j = 0; j < J; ++j) {
         if (hX.getFormatType(j) == DENSE || hX.getFormatType(j) == INTERCEPT) {
             sparseIndices.push_back(NULL);
+        } else if (hX.getFormatType(j) == INTERACTION) {
+            std::set<int> unique;
+            InteractionIterator<RealType> it(hX, j);
+            for (; it; ++it) { // Loop through non-zero entries only
+                const int k = it.index();
+                const int i = (k < hPidSize) ? hPid[k] : k;
+                if (i < max) {
+                    unique.insert(i);
+                }
+            }
+            auto indices = bsccs::make_shared<IndexVector>(unique.begin(), unique.end());
+            sparseIndices.push_back(indices);
         } else {
             std::set<int> unique;
             const size_t n = hX.getNumberOfEntries(j);
@@ -1931,6 +2491,8 @@ void ModelSpecifics<BaseModel,RealType>::initialize(
     if (initializeAccumulationVectors()) {
         setPidForAccumulation(static_cast<double*>(nullptr)); // calls setupSparseIndices() before returning
     } else {
+        hPid = const_cast<int*>(hPidOriginal.data()); // Appending rows may have moved the stratum ids
+        hPidSize = hPidOriginal.size();
         // TODO Suspect below is not necessary for non-grouped data.
         // If true, then fill with pointers to CompressedDataColumn and do not delete in destructor
         setupSparseIndices(N); // Need to be recomputed when hPid change!
@@ -1951,6 +2513,131 @@ void ModelSpecifics<BaseModel,RealType>::initialize(
 
 }
 
+template <class BaseModel,typename RealType>
+bool ModelSpecifics<BaseModel,RealType>::appendRows(int iN, int iK, int iJ, const double* beta,
+                                                    bool incremental) {
+
+    hXt.reset(); // Transpose no longer covers every row
+    makeDirty();
+
+    // Stratum accumulation, tie handling and two-way scans depend on all rows in a stratum
+    bool inPlace = incremental && !initializeAccumulationVectors() && !allocateNtoKIndices() &&
+        !sortPid() && !BaseModel::exactTies && !BaseModel::isTwoWayScan;
+    for (int j = 0; j < iJ && inPlace; ++j) {
+        const FormatType format = hX.getFormatType(j);
+        inPlace = format == INDICATOR || format == SPARSE || format == INTERCEPT ||
+            (format == DENSE && hX.getDataVectorSTL(j).size() == static_cast<size_t>(iK));
+    }
+
+    if (!inPlace) {
+        initialize(iN, iK, iJ, nullptr, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+        return false;
+    }
+
+    const size_t oldN = N;
+    const size_t oldK = K;
+    const size_t oldJ = J;
+
+    N = iN;
+    K = iK;
+    J = iJ;
+    hPid = const_cast<int*>(hPidOriginal.data());
+    hPidSize = hPidOriginal.size();
+
+    offsExpXBeta.resize(K);
+    hXBeta.resize(K, static_cast<RealType>(0));
+    hKWeight.resize(K, static_cast<RealType>(1));
+    hYWeight.resize(K);
+    if (hNWeight.size() < N + 1) {
+        hNWeight.resize(N + 1, static_cast<RealType>(0));
+    }
+
+    if (allocateXjY()) {
+        hXjY.resize(J, static_cast<RealType>(0));
+    }
+
+    if (allocateXjX()) {
+        hXjX.resize(J, static_cast<RealType>(0));
+    }
+
+    size_t alignedLength = getAlignedLength(N + 1);
+    denomPid.resize(alignedLength);
+    numerPid.resize(alignedLength);
+    numerPid2.resize(alignedLength);
+    std::fill(denomPid.begin() + oldN, denomPid.begin() + N, BaseModel::getDenomNullValue());
+
+    for (size_t k = oldK; k < K; ++k) {
+        incrementByGroup(hNWeight.data(), hPid, k, BaseModel::observationCount(hY[k]));
+    }
+
+    // Visit only the entries in appended rows; new columns hold nothing else
+    for (size_t j = 0; j < J; ++j) {
+        const RealType b = static_cast<RealType>(beta[j]);
+        const FormatType format = hX.getFormatType(j);
+        IndexVectorPtr indices;
+        if (j < oldJ) {
+            indices = sparseIndices[j];
+        } else if (format == INDICATOR || format == SPARSE) {
+            indices = bsccs::make_shared<IndexVector>();
+        }
+
+        auto appendEntry = [&](const int k, const RealType x) {
+            hXBeta[k] += x * b;
+            if (allocateXjY()) {
+                hXjY[j] += x * (BaseModel::isSurvivalModel ?
+                    BaseModel::observationCount(hY[k]) : hY[k]);
+            }
+            if (allocateXjX()) {
+                hXjX[j] += x * x;
+            }
+            if (indices) {
+                const int i = (k < static_cast<int>(hPidSize)) ? hPid[k] : k;
+                if (i < static_cast<int>(N) && (indices->empty() || indices->back() < i)) {
+                    indices->push_back(i); // Strata are sorted, so indices stay unique and ordered
+                }
+            }
+        };
+
+        if (format == INTERCEPT) {
+            for (size_t k = oldK; k < K; ++k) {
+                appendEntry(k, static_cast<RealType>(1));
+            }
+        } else if (format == DENSE) {
+            const RealType* values = hX.getDataVector(j);
+            for (size_t k = oldK; k < K; ++k) {
+                appendEntry(k, values[k]);
+            }
+        } else {
+            const std::vector<int>& rows = hX.getCompressedColumnVectorSTL(j);
+            const RealType* values = (format == SPARSE) ? hX.getDataVector(j) : nullptr;
+            auto it = std::lower_bound(rows.begin(), rows.end(), static_cast<int>(oldK));
+            for (; it != rows.end(); ++it) {
+                appendEntry(*it, values ? values[it - rows.begin()] : static_cast<RealType>(1));
+            }
+        }
+
+        if (j >= oldJ) {
+            sparseIndices.push_back(indices);
+        }
+    }
+
+    const bool hasOffs = hOffs.size() > 0;
+    for (size_t k = oldK; k < K; ++k) {
+        if (BaseModel::likelihoodHasFixedTerms) {
+            auto offs = hasOffs ? hOffs[k] : static_cast<RealType>(0);
+            logLikelihoodFixedTerm += BaseModel::logLikeFixedTermsContrib(hY[k], offs, offs);
+        }
+        if (BaseModel::likelihoodHasDenominator) {
+            offsExpXBeta[k] = BaseModel::getOffsExpXBeta(hOffs.data(), hXBeta[k], hY[k], k);
+            incrementByGroup(denomPid.data(), hPid, k, offsExpXBeta[k]);
+        }
+    }
+
+    deviceInitialization();
+
+    return true;
+}
+
 } // namespace
 
 #endif /* MODELSPECIFICS_HPP_ */
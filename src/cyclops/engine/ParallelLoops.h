@@ -4,9 +4,12 @@
 
 #include <vector>
 #include <numeric>
+#include <algorithm>
 #include <thread>
 #include <boost/iterator/counting_iterator.hpp>
 
+#include "Thread.h"
+
 // #define USE_RCPP_PARALLEL
 #undef USE_RCPP_PARALLEL
 
@@ -31,10 +34,12 @@ struct RcppParallel { };
 
 struct C11Threads {
 
-	C11Threads(int threads, size_t size = 100) : nThreads(threads), minSize(size) { }
+	C11Threads(int threads, size_t size = 100, WorkerPool* pool = nullptr)
+		: nThreads(threads), minSize(size), pool(pool) { }
 
 	int nThreads;
 	size_t minSize;
+	WorkerPool* pool;
 };
 
 // struct C11ThreadPool {
@@ -246,6 +251,41 @@ namespace variants {
         return std::for_each(first, last, f);
     }
 
+    // Splits [begin, end) into one contiguous chunk per thread; calls function(chunk, chunkBegin, chunkEnd)
+    template <class Function>
+    inline void for_each_chunk(int begin, int end, Function function, C11Threads& info) {
+        const int length = end - begin;
+        const int nThreads = std::min(info.nThreads, length);
+
+        if (nThreads <= 1 || static_cast<size_t>(length) < info.minSize) {
+            function(0, begin, end);
+            return;
+        }
+
+        const int chunkSize = length / nThreads;
+
+        if (info.pool) {
+            info.pool->run(nThreads, nThreads, [&function, begin, end, chunkSize, nThreads](size_t chunk) {
+                const int start = begin + static_cast<int>(chunk) * chunkSize;
+                function(static_cast<int>(chunk), start,
+                         static_cast<int>(chunk) == nThreads - 1 ? end : start + chunkSize);
+            });
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(nThreads - 1);
+        int start = begin;
+        for (int i = 0; i < nThreads - 1; ++i, start += chunkSize) {
+            workers.emplace_back(function, i, start, start + chunkSize);
+        }
+        function(nThreads - 1, start, end);
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
 //     template <class UnaryFunction, class Specifics>
 //     inline UnaryFunction for_each(int first, int last, UnaryFunction f, Specifics) {
 //         for (; first != last; ++first) {
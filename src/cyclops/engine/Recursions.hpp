@@ -13,6 +13,8 @@
 #include <cstdlib>
 #include <algorithm>
 #include <numeric>
+#include <vector>
+#include <limits>
 
 namespace bsccs {
 
@@ -318,6 +320,134 @@ std::vector<T> computeHowardRecursion(UIteratorType itExpXBeta, SparseIteratorTy
 	return result;
 }
 
+// Reusable buffers for computeScaledHowardRecursion; grown on demand, never shrunk
+template <typename T>
+struct HowardWorkspace {
+	std::vector<T> B;      // (B, dB, ddB) per number of cases
+	std::vector<int> e;    // binary exponent shared by each triple
+	std::vector<T> x;      // dense covariate slice of the stratum
+
+	void reserve(int numSubjects, int numCases) {
+		if (B.size() < static_cast<size_t>(3 * (numCases + 1))) {
+			B.resize(3 * (numCases + 1));
+			e.resize(numCases + 1);
+		}
+		if (x.size() < static_cast<size_t>(numSubjects)) {
+			x.resize(numSubjects);
+		}
+	}
+};
+
+namespace detail {
+
+	template <typename T>
+	inline void normalize(T* b, int* e) {
+		using std::abs;
+		static const T upper = std::ldexp(static_cast<T>(1), std::numeric_limits<T>::max_exponent / 4);
+		static const T lower = static_cast<T>(1) / upper;
+		const T m = std::max(abs(b[0]), std::max(abs(b[1]), abs(b[2])));
+		if (m == static_cast<T>(0)) {
+			*e = 0;
+		} else if (m > upper || m < lower) {
+			int shift;
+			std::frexp(m, &shift);
+			b[0] = std::ldexp(b[0], -shift);
+			b[1] = std::ldexp(b[1], -shift);
+			b[2] = std::ldexp(b[2], -shift);
+			*e += shift;
+		}
+	}
+
+} // namespace detail
+
+/*
+ * Same recursion as computeHowardRecursion, but each (B, dB, ddB) triple carries its own
+ * binary exponent and exp(x beta) is shifted by the stratum maximum, so intermediate values
+ * neither overflow nor underflow. Returns dB / B and ddB / B for numCases.
+ */
+template <typename T, typename XBetaIteratorType>
+void computeScaledHowardRecursion(XBetaIteratorType itXBeta, const T* x,
+		int numSubjects, int numCases, HowardWorkspace<T>& workspace,
+		T* firstRatio, T* secondRatio) {
+
+	T maxXBeta = *itXBeta;
+	{
+		auto it = itXBeta;
+		for (int n = 0; n < numSubjects; ++n, ++it) {
+			maxXBeta = std::max(maxXBeta, static_cast<T>(*it));
+		}
+	}
+
+	if (numCases == 1) {
+		T B = 0;
+		T dB = 0;
+		T ddB = 0;
+		for (int n = 0; n < numSubjects; ++n, ++itXBeta) {
+			const T t = std::exp(*itXBeta - maxXBeta);
+			B += t;
+			dB += t * x[n];
+			ddB += t * x[n] * x[n];
+		}
+		*firstRatio = dB / B;
+		*secondRatio = ddB / B;
+		return;
+	}
+
+	static const T ln2 = std::log(static_cast<T>(2));
+
+	T* B = workspace.B.data();
+	int* e = workspace.e.data();
+
+	std::fill(B, B + 3 * (numCases + 1), static_cast<T>(0));
+	std::fill(e, e + numCases + 1, 0);
+	B[0] = 1;
+
+	int start = 1;
+	int end = 0;
+
+	for (int n = 1; n <= numSubjects; ++n, ++itXBeta) {
+		const T xn = x[n - 1];
+		// exp(x beta - max) = t * 2^tE, kept apart so that tiny weights do not underflow
+		const T shifted = static_cast<T>(*itXBeta) - maxXBeta;
+		const int tE = static_cast<int>(std::floor(shifted / ln2));
+		const T t = std::exp(shifted - tE * ln2);
+		if (n > numSubjects - numCases + 1) start++;
+		if (n <= numCases) end++;
+
+		// In-place update; descending m reads level m - 1 before it changes
+		for (int m = end; m >= start; --m) {
+			const T* prev = B + 3 * (m - 1);
+			T* curr = B + 3 * m;
+
+			const T tb = t * prev[0];
+			const T tdb = t * prev[1];
+			const T xtb = xn * tb;
+
+			T add[3] = { tb, tdb + xtb, t * prev[2] + xn * xtb + 2 * xn * tdb };
+			int addE = e[m - 1] + tE;
+			detail::normalize(add, &addE);
+
+			if (curr[0] == 0 && curr[1] == 0 && curr[2] == 0) {
+				curr[0] = add[0]; curr[1] = add[1]; curr[2] = add[2];
+				e[m] = addE;
+			} else {
+				const int E = std::max(e[m], addE);
+				const int currShift = e[m] - E;
+				const int addShift = addE - E;
+				curr[0] = std::ldexp(curr[0], currShift) + std::ldexp(add[0], addShift);
+				curr[1] = std::ldexp(curr[1], currShift) + std::ldexp(add[1], addShift);
+				curr[2] = std::ldexp(curr[2], currShift) + std::ldexp(add[2], addShift);
+				e[m] = E;
+			}
+			detail::normalize(curr, &e[m]);
+		}
+	}
+
+	const T* last = B + 3 * numCases;
+	*firstRatio = last[1] / last[0];
+	*secondRatio = last[2] / last[0];
+}
+
 } // namespace
 
 #endif /* RECURSIONS_HPP_ */
@@ -0,0 +1,106 @@
+/*
+ * BinaryStream.h
+ *
+ * Native-endian binary records for solver snapshots and cross-validation checkpoints.  Each
+ * record starts with a four-character tag and a version; vectors are length-prefixed.
+ */
+
+#ifndef BINARYSTREAM_H_
+#define BINARYSTREAM_H_
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bsccs {
+
+namespace binary {
+
+template <typename T>
+void write(std::ostream& stream, const T& value) {
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void write(std::ostream& stream, const std::vector<T>& values) {
+	write(stream, static_cast<std::uint64_t>(values.size()));
+	if (!values.empty()) {
+		stream.write(reinterpret_cast<const char*>(values.data()), sizeof(T) * values.size());
+	}
+}
+
+inline void write(std::ostream& stream, const std::string& value) {
+	write(stream, static_cast<std::uint64_t>(value.size()));
+	stream.write(value.data(), value.size());
+}
+
+template <typename T>
+bool read(std::istream& stream, T& value) {
+	stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return static_cast<bool>(stream);
+}
+
+// True if 'count' elements of 'size' bytes remain, so a corrupt length fails before allocating
+inline bool hasRemaining(std::istream& stream, std::uint64_t count, std::uint64_t size) {
+	const std::streampos current = stream.tellg();
+	if (current == std::streampos(-1)) {
+		return false;
+	}
+	stream.seekg(0, std::ios::end);
+	const std::streampos end = stream.tellg();
+	stream.seekg(current);
+	if (end == std::streampos(-1) || !stream) {
+		return false;
+	}
+	return count <= static_cast<std::uint64_t>(end - current) / size;
+}
+
+template <typename T>
+bool read(std::istream& stream, std::vector<T>& values) {
+	std::uint64_t size;
+	if (!read(stream, size) || !hasRemaining(stream, size, sizeof(T))) {
+		return false;
+	}
+	values.resize(size);
+	if (size > 0) {
+		stream.read(reinterpret_cast<char*>(values.data()), sizeof(T) * size);
+	}
+	return static_cast<bool>(stream);
+}
+
+inline bool read(std::istream& stream, std::string& value) {
+	std::uint64_t size;
+	if (!read(stream, size) || !hasRemaining(stream, size, 1)) {
+		return false;
+	}
+	value.resize(size);
+	if (size > 0) {
+		stream.read(&value[0], size);
+	}
+	return static_cast<bool>(stream);
+}
+
+inline void writeHeader(std::ostream& stream, const char* tag, std::int32_t version) {
+	stream.write(tag, 4);
+	write(stream, version);
+	write(stream, static_cast<std::int32_t>(sizeof(double)));
+}
+
+// False unless the stream opens with this tag at this version
+inline bool readHeader(std::istream& stream, const char* tag, std::int32_t version) {
+	char found[4];
+	std::int32_t foundVersion, doubleSize;
+	stream.read(found, 4);
+	return stream && std::memcmp(found, tag, 4) == 0 &&
+		read(stream, foundVersion) && foundVersion == version &&
+		read(stream, doubleSize) && doubleSize == static_cast<std::int32_t>(sizeof(double));
+}
+
+} // namespace binary
+
+} // namespace bsccs
+
+#endif /* BINARYSTREAM_H_ */
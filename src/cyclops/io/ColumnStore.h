@@ -0,0 +1,307 @@
+/*
+ * ColumnStore.h
+ *
+ * Out-of-core backing for the columns of a CompressedDataMatrix.  Column payloads are written
+ * once to a scratch file and paged back in on access, keeping at most 'cacheBytes' resident;
+ * the least recently used columns are released first.  A background thread reads ahead along
+ * the order in which the columns were last visited, which for cyclic coordinate descent is
+ * the order of the next sweep.
+ */
+
+#ifndef COLUMNSTORE_H_
+#define COLUMNSTORE_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CompressedDataMatrix.h"
+
+namespace bsccs {
+
+template <typename RealType>
+class ColumnStore : public ColumnPager {
+public:
+
+	typedef CompressedDataColumn<RealType> Column;
+	typedef typename Column::RealVector RealVector;
+	typedef typename Column::RealVectorPtr RealVectorPtr;
+	typedef std::vector<typename Column::Ptr> ColumnVector;
+
+	// Fewest columns kept resident regardless of the budget; Fisher information and the
+	// Hessian cross terms hold two columns at once
+	static const size_t minimumResident = 4;
+
+	// Spills every DENSE, SPARSE and INDICATOR column of 'matrixColumns' to 'file' and releases
+	// their payloads; throws std::runtime_error if the file cannot be written
+	ColumnStore(ColumnVector& matrixColumns, const std::string& file, size_t budget,
+			int depth) : columns(matrixColumns), fileName(file), cacheBytes(budget),
+			readAhead(std::max(depth, 0)), extents(matrixColumns.size()),
+			resident(matrixColumns.size(), true), lruPosition(matrixColumns.size()),
+			successor(matrixColumns.size(), -1), lastIndex(-1), residentBytes(0),
+			inFlight(-1), stop(false), pageIns(0), readAheadHits(0) {
+
+		std::ofstream out(fileName.c_str(), std::ios::binary | std::ios::trunc);
+		if (!out) {
+			throw std::runtime_error("Unable to open column file " + fileName);
+		}
+		for (size_t j = 0; j < columns.size(); ++j) {
+			Column& column = *columns[j];
+			const FormatType format = column.getFormatType();
+			if (format != DENSE && format != SPARSE && format != INDICATOR) {
+				continue;
+			}
+			Extent& extent = extents[j];
+			extent.spilled = true;
+			extent.offset = static_cast<std::uint64_t>(out.tellp());
+			if (format != DENSE) {
+				const IntVector& rows = column.getColumnsVector();
+				extent.nIndices = rows.size();
+				out.write(reinterpret_cast<const char*>(rows.data()),
+					rows.size() * sizeof(int));
+			}
+			if (format != INDICATOR) {
+				const RealVector& values = column.getDataVector();
+				extent.nValues = values.size();
+				out.write(reinterpret_cast<const char*>(values.data()),
+					values.size() * sizeof(RealType));
+			}
+			column.setPager(this, static_cast<int>(j));
+			column.releasePayload();
+			resident[j] = false;
+		}
+		out.close();
+		if (!out) {
+			std::remove(fileName.c_str());
+			throw std::runtime_error("Unable to write column file " + fileName);
+		}
+
+		reader.open(fileName.c_str(), std::ios::binary);
+		if (!reader) {
+			std::remove(fileName.c_str());
+			throw std::runtime_error("Unable to read column file " + fileName);
+		}
+		if (readAhead > 0) {
+			worker = std::thread(&ColumnStore::readAheadLoop, this);
+		}
+	}
+
+	virtual ~ColumnStore() {
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stop = true;
+		}
+		wake.notify_all();
+		if (worker.joinable()) {
+			worker.join();
+		}
+		reader.close();
+		std::remove(fileName.c_str());
+	}
+
+	void page(int index) {
+		std::unique_lock<std::mutex> guard(lock);
+		const bool moved = index != lastIndex;
+		if (moved) {
+			if (lastIndex >= 0) {
+				successor[lastIndex] = index; // Learn the visiting order
+			}
+			lastIndex = index;
+		}
+
+		if (!resident[index]) {
+			Payload payload;
+			if (inFlight == index) {
+				ready.wait(guard, [this, index] { return inFlight != index; });
+			}
+			auto found = staged.find(index);
+			if (found != staged.end()) {
+				payload = found->second;
+				staged.erase(found);
+				++readAheadHits;
+			} else {
+				guard.unlock();
+				payload = read(reader, index);
+				guard.lock();
+				staged.erase(index); // Drop a read-ahead that raced with this read
+			}
+			columns[index]->restorePayload(payload.indices, payload.values);
+			resident[index] = true;
+			residentBytes += getBytes(index);
+			lru.push_front(index);
+			lruPosition[index] = lru.begin();
+			++pageIns;
+			evict();
+		} else if (moved && extents[index].spilled) {
+			lru.splice(lru.begin(), lru, lruPosition[index]);
+		}
+
+		if (moved && readAhead > 0) {
+			scheduleReadAhead(index);
+			guard.unlock();
+			wake.notify_one();
+		}
+	}
+
+	size_t getResidentBytes() const { return residentBytes; }
+
+	size_t getPageInCount() const { return pageIns; }
+
+	size_t getReadAheadHitCount() const { return readAheadHits; }
+
+	const std::string& getFileName() const { return fileName; }
+
+private:
+
+	struct Extent {
+		std::uint64_t offset;
+		std::uint64_t nIndices;
+		std::uint64_t nValues;
+		bool spilled;
+
+		Extent() : offset(0), nIndices(0), nValues(0), spilled(false) { }
+	};
+
+	struct Payload {
+		IntVectorPtr indices;
+		RealVectorPtr values;
+	};
+
+	size_t getBytes(int index) const {
+		const Extent& extent = extents[index];
+		return extent.nIndices * sizeof(int) + extent.nValues * sizeof(RealType);
+	}
+
+	Payload read(std::ifstream& in, int index) const { // Extents are immutable after spilling
+		const Extent& extent = extents[index];
+		const FormatType format = columns[index]->getFormatType();
+		Payload payload;
+		in.clear();
+		in.seekg(static_cast<std::streamoff>(extent.offset));
+		if (format != DENSE) {
+			payload.indices = bsccs::make_shared<IntVector>(extent.nIndices);
+			in.read(reinterpret_cast<char*>(payload.indices->data()),
+				extent.nIndices * sizeof(int));
+		}
+		if (format != INDICATOR) {
+			payload.values = bsccs::make_shared<RealVector>(extent.nValues);
+			in.read(reinterpret_cast<char*>(payload.values->data()),
+				extent.nValues * sizeof(RealType));
+		}
+		if (!in) {
+			throw std::runtime_error("Unable to read column file " + fileName);
+		}
+		return payload;
+	}
+
+	void evict() { // Requires lock
+		while (residentBytes > cacheBytes && lru.size() > minimumResident) {
+			const int victim = lru.back();
+			lru.pop_back();
+			columns[victim]->releasePayload();
+			resident[victim] = false;
+			residentBytes -= getBytes(victim);
+		}
+	}
+
+	int nextInOrder(int index) const {
+		if (successor[index] >= 0) {
+			return successor[index];
+		}
+		return (index + 1 < static_cast<int>(columns.size())) ? index + 1 : 0;
+	}
+
+	void scheduleReadAhead(int index) { // Requires lock
+		requests.clear(); // Earlier requests are stale once the sweep has moved on
+		std::vector<int> targets;
+		int next = index;
+		for (size_t step = 0; step < columns.size() && targets.size() <
+				static_cast<size_t>(readAhead); ++step) {
+			next = nextInOrder(next);
+			if (next == index) {
+				break;
+			}
+			if (extents[next].spilled && !resident[next]) {
+				targets.push_back(next);
+				if (next != inFlight && staged.find(next) == staged.end()) {
+					requests.push_back(next);
+				}
+			}
+		}
+		for (auto it = staged.begin(); it != staged.end(); ) { // Bound staged memory
+			if (std::find(targets.begin(), targets.end(), it->first) == targets.end()) {
+				it = staged.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	void readAheadLoop() {
+		std::ifstream in(fileName.c_str(), std::ios::binary);
+		std::unique_lock<std::mutex> guard(lock);
+		for (;;) {
+			wake.wait(guard, [this] { return stop || !requests.empty(); });
+			if (stop) {
+				return;
+			}
+			const int index = requests.front();
+			requests.pop_front();
+			inFlight = index;
+			guard.unlock();
+			Payload payload;
+			bool success = true;
+			try {
+				payload = read(in, index);
+			} catch (const std::exception&) {
+				success = false; // The main thread retries synchronously and reports
+			}
+			guard.lock();
+			if (success && !resident[index]) {
+				staged[index] = payload;
+			}
+			inFlight = -1;
+			ready.notify_all();
+		}
+	}
+
+	ColumnVector& columns;
+	const std::string fileName;
+	const size_t cacheBytes;
+	const int readAhead;
+
+	std::vector<Extent> extents;
+	std::vector<bool> resident;
+	std::list<int> lru; // Resident spilled columns, most recently used first
+	std::vector<std::list<int>::iterator> lruPosition;
+	std::vector<int> successor; // Column visited after each column in the last sweep
+	int lastIndex;
+	size_t residentBytes;
+	std::ifstream reader;
+
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable ready;
+	std::deque<int> requests;
+	std::map<int, Payload> staged;
+	int inFlight;
+	bool stop;
+
+	size_t pageIns;
+	size_t readAheadHits;
+};
+
+} // namespace
+
+#endif /* COLUMNSTORE_H_ */
@@ -45,6 +45,32 @@ public:
 		return sparseMap[covariate];
 	}
 
+	// Column holding this covariate or -1; entries made stale by reordering the matrix, or
+	// columns loaded without the indexer, are found again by label
+	int findIndex(const IdType& covariate) {
+		auto entry = sparseMap.find(covariate);
+		if (entry != sparseMap.end() && entry->second < static_cast<int>(dataMatrix.getNumberOfColumns()) &&
+				dataMatrix.getColumn(entry->second).getNumericalLabel() == covariate) {
+			return entry->second;
+		}
+		const int index = dataMatrix.getColumnIndexByName(covariate);
+		if (index >= 0) {
+			sparseMap[covariate] = index;
+		} else if (entry != sparseMap.end()) {
+			sparseMap.erase(entry);
+		}
+		return index;
+	}
+
+	// Keeps covariates pointing at their columns after a column is inserted at this index
+	void insertColumn(int index) {
+		for (auto& entry : sparseMap) {
+			if (entry.second >= index) {
+				++entry.second;
+			}
+		}
+	}
+
 private:
 	CompressedDataMatrix<RealType>& dataMatrix;
 //	int nCovariates;
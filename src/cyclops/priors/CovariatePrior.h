@@ -13,6 +13,7 @@
 #include <cmath>
 #include <sstream>
 #include <limits>
+#include <map>
 
 #include <iostream> // TODO Remove
 
@@ -124,6 +125,23 @@ struct CacheCallback : public Cachable {
 
 typedef CallbackSharedPtr<double,CacheCallback> VariancePtr;
 
+// Fresh variance parameters for cloned priors; parameters shared by several priors stay shared
+class VarianceCopier {
+public:
+    VariancePtr operator()(const VariancePtr& original) {
+        auto found = copies.find(&original.get());
+        if (found != copies.end()) {
+            return found->second;
+        }
+        VariancePtr copy(bsccs::make_shared<double>(original.get()));
+        copies.insert(std::make_pair(&original.get(), copy));
+        return copy;
+    }
+
+private:
+    std::map<const double*, VariancePtr> copies;
+};
+
 class CovariatePrior; // forward declaration
 typedef bsccs::shared_ptr<CovariatePrior> PriorPtr;
 
@@ -150,6 +168,23 @@ public:
 
 	virtual std::vector<VariancePtr> getVarianceParameters() const = 0 ; // pure virtual
 
+	// Gradient and curvature of the negative log density at beta[index]; returns false if the
+	// prior is not twice differentiable there
+	virtual bool getGradientHessian(const DoubleVector& beta, const int index, GradientHessian& gh) const {
+		return false;
+	}
+
+	// Weight lambda when the negative log density is lambda * |beta[index]| plus a constant;
+	// returns false otherwise
+	virtual bool getL1Penalty(const int index, double& lambda) const {
+		return false;
+	}
+
+	// Copy with its own variance parameters, or null if this prior cannot be copied
+	virtual PriorPtr clone(VarianceCopier& copy) const {
+		return PriorPtr();
+	}
+
 	static PriorPtr makePrior(PriorType priorType, double variance);
 
 	static VariancePtr makeVariance(double variance) {
@@ -171,6 +206,10 @@ public:
 		return std::vector<VariancePtr>();
 	}
 
+	PriorPtr clone(VarianceCopier& copy) const {
+		return bsccs::make_shared<NoPrior>();
+	}
+
 	const std::string getDescription() const {
 		return "None";
 	}
@@ -187,6 +226,12 @@ public:
 		return -(gh.first / gh.second); // No regularization
 	}
 
+	bool getGradientHessian(const DoubleVector& beta, const int index, GradientHessian& gh) const {
+		gh.first = 0.0;
+		gh.second = 0.0;
+		return true;
+	}
+
 	bool getSupportsKktSwindle() const {
 		return false;
 	}
@@ -237,6 +282,11 @@ public:
 		return lambda;
 	}
 
+	bool getL1Penalty(const int index, double& lambda) const {
+		lambda = getLambda();
+		return true;
+	}
+
 	double getDelta(GradientHessian gh, const DoubleVector& betaVector, const int index) const {
 
 		double beta = betaVector[index];
@@ -278,6 +328,10 @@ public:
 		return tmp;
 	}
 
+	PriorPtr clone(VarianceCopier& copy) const {
+		return bsccs::make_shared<LaplacePrior>(copy(variance));
+	}
+
 protected:
 	double convertVarianceToHyperparameter(double value) const {
 		return std::sqrt(2.0 / value);
@@ -357,6 +411,15 @@ public:
 
 	double getDelta(const GradientHessian gh, const DoubleVector& betaVector, const int index) const;
 
+	bool getL1Penalty(const int index, double& lambda) const {
+		return false; // Couples neighbors
+	}
+
+	PriorPtr clone(VarianceCopier& copy) const {
+		return bsccs::make_shared<FusedLaplacePrior>(copy(getVarianceParameters()[0]),
+			copy(variance2), neighborList);
+	}
+
 private:
 	double getEpsilon() const {
 		return convertVarianceToHyperparameter(variance2.get());
@@ -414,12 +477,23 @@ public:
 				  (gh.second + (1.0 / sigma2Beta));
 	}
 
+	bool getGradientHessian(const DoubleVector& betaVector, const int index, GradientHessian& gh) const {
+		double sigma2Beta = getVariance();
+		gh.first = betaVector[index] / sigma2Beta;
+		gh.second = 1.0 / sigma2Beta;
+		return true;
+	}
+
 	std::vector<VariancePtr> getVarianceParameters() const {
 	    auto tmp = std::vector<VariancePtr>();
 	    tmp.push_back(variance);
 		return tmp;
 	}
 
+	PriorPtr clone(VarianceCopier& copy) const {
+		return bsccs::make_shared<NormalPrior>(copy(variance));
+	}
+
 protected:
     double getVariance() const {
         return variance.get();
@@ -509,6 +583,10 @@ public:
         return tmp;
     }
 
+    PriorPtr clone(VarianceCopier& copy) const {
+        return bsccs::make_shared<BarUpdatePrior>(copy(variance));
+    }
+
 protected:
     double getVariance() const {
         return variance.get();
@@ -568,6 +646,11 @@ public:
         return tmp;
     }
 
+    PriorPtr clone(VarianceCopier& copy) const {
+        return bsccs::make_shared<HierarchicalNormalPrior>(
+            copy(NormalPrior::getVarianceParameters()[0]), copy(variance2), neighborList);
+    }
+
 protected:
     double getVariance2() const { return variance2.get(); }
 
@@ -576,6 +659,82 @@ private:
     NeighborList neighborList;
 };
 
+// Prior for a column that stands in for `multiplicity` identical covariates.  The coefficient s is
+// the sum of the copies' coefficients, each copy carries the base prior, and the copies split s
+// equally (an optimum for any convex base prior), so the penalty on s is k * p(s / k).  The base
+// prior may only read beta[index].
+class CollapsedPrior : public CovariatePrior {
+public:
+
+    CollapsedPrior(PriorPtr base, int multiplicity) : CovariatePrior(), base(base),
+        multiplicity(multiplicity) { }
+
+    virtual ~CollapsedPrior() { }
+
+    const std::string getDescription() const {
+        std::stringstream info;
+        info << base->getDescription() << "x" << multiplicity;
+        return info.str();
+    }
+
+    bool getIsRegularized() const {
+        return base->getIsRegularized();
+    }
+
+    bool getSupportsKktSwindle() const {
+        return base->getSupportsKktSwindle();
+    }
+
+    double getKktBoundary() const { // d/ds k p(s / k) = p'(s / k)
+        return base->getKktBoundary();
+    }
+
+    double logDensity(const DoubleVector& beta, const int index) const {
+        return multiplicity * base->logDensity(perCopy(beta, index), index);
+    }
+
+    double getDelta(GradientHessian gh, const DoubleVector& betaVector, const int index) const {
+        // Newton step on b = s / k for L(k b) / k + p(b), mapped back to s
+        gh.second *= multiplicity;
+        return multiplicity * base->getDelta(gh, perCopy(betaVector, index), index);
+    }
+
+    bool getGradientHessian(const DoubleVector& betaVector, const int index, GradientHessian& gh) const {
+        // With q = -log p: d/ds k q(s / k) = q'(s / k) and d2/ds2 k q(s / k) = q''(s / k) / k
+        if (!base->getGradientHessian(perCopy(betaVector, index), index, gh)) {
+            return false;
+        }
+        gh.second /= multiplicity;
+        return true;
+    }
+
+    bool getL1Penalty(const int index, double& lambda) const { // k * lambda * |s / k| = lambda * |s|
+        return base->getL1Penalty(index, lambda);
+    }
+
+    std::vector<VariancePtr> getVarianceParameters() const {
+        return base->getVarianceParameters();
+    }
+
+    PriorPtr clone(VarianceCopier& copy) const {
+        PriorPtr baseCopy = base->clone(copy);
+        return baseCopy ? bsccs::make_shared<CollapsedPrior>(baseCopy, multiplicity) : PriorPtr();
+    }
+
+private:
+    const DoubleVector& perCopy(const DoubleVector& beta, const int index) const {
+        static thread_local DoubleVector scratch; // Priors are shared across CCD clones
+        if (scratch.size() < beta.size()) {
+            scratch.resize(beta.size());
+        }
+        scratch[index] = beta[index] / multiplicity;
+        return scratch;
+    }
+
+    PriorPtr base;
+    int multiplicity;
+};
+
 } /* namespace priors */
 } /* namespace bsccs */
 #endif /* COVARIATEPRIOR_H_ */
@@ -9,6 +9,7 @@
 #define JOINTPRIOR_H_
 
 #include <algorithm>
+#include <map>
 
 #include "Types.h"
 #include "priors/CovariatePrior.h"
@@ -18,6 +19,9 @@ namespace priors {
 
 typedef std::vector<double> DoubleVector;
 
+class JointPrior; // forward declaration
+typedef bsccs::shared_ptr<JointPrior> JointPriorPtr;
+
 class JointPrior {
 public:
 	JointPrior() { }
@@ -43,7 +47,21 @@ public:
 
 	virtual double getKktBoundary(const int index) const = 0; // pure virtual
 
-//  	virtual JointPrior* clone() const = 0; // pure virtual
+	// See CovariatePrior::getGradientHessian(); priors that couple coefficients return false
+	virtual bool getGradientHessian(const DoubleVector& beta, const int index, GradientHessian& gh) const {
+		return false;
+	}
+
+	// See CovariatePrior::getL1Penalty()
+	virtual bool getL1Penalty(const int index, double& lambda) const {
+		return false;
+	}
+
+	// Copy with its own variance parameters, so clones can be evaluated at different
+	// hyperparameters concurrently; null if any covariate prior cannot be copied
+	virtual JointPriorPtr clone() const {
+		return JointPriorPtr();
+	}
 
     void addVarianceParameter(const VariancePtr& ptr) {
         if (std::find(variance.begin(), variance.end(), ptr) == variance.end()) {
@@ -72,6 +90,13 @@ public:
 
 protected:
 
+	void copyVariance(const JointPrior& original, VarianceCopier& copy) {
+		variance.clear();
+		for (const auto& ptr : original.variance) {
+			variance.push_back(copy(ptr));
+		}
+	}
+
     std::vector<VariancePtr> variance;
 	// std::vector<double> variance;
 	// std::vector<std::vector<int>> varianceMap;
@@ -94,6 +119,10 @@ public:
 		addVarianceParameters(newPrior->getVarianceParameters());
 	}
 
+	PriorPtr getPrior(int index) const {
+		return listPriors[index];
+	}
+
 	const std::string getDescription() const {
 	    std::ostringstream stream;
 	    for (PriorPtr prior : uniquePriors) {
@@ -138,6 +167,14 @@ public:
 		return listPriors[index]->getDelta(gh, beta, index);
 	}
 
+	bool getGradientHessian(const DoubleVector& beta, const int index, GradientHessian& gh) const {
+		return listPriors[index]->getGradientHessian(beta, index, gh);
+	}
+
+	bool getL1Penalty(const int index, double& lambda) const {
+		return listPriors[index]->getL1Penalty(index, lambda);
+	}
+
 	bool getSupportsKktSwindle(const int index) const {
 		return listPriors[index]->getSupportsKktSwindle();
 	}
@@ -156,6 +193,31 @@ public:
 		return false;
 	}
 
+	JointPriorPtr clone() const {
+		VarianceCopier copy;
+		std::map<const CovariatePrior*, PriorPtr> copies;
+		PriorList newUniquePriors;
+		for (const auto& prior : uniquePriors) {
+			PriorPtr& newPrior = copies[prior.get()];
+			if (!newPrior) {
+				newPrior = prior->clone(copy);
+				if (!newPrior) {
+					return JointPriorPtr();
+				}
+			}
+			newUniquePriors.push_back(newPrior);
+		}
+		PriorList newListPriors;
+		newListPriors.reserve(listPriors.size());
+		for (const auto& prior : listPriors) {
+			newListPriors.push_back(copies[prior.get()]);
+		}
+		auto cloned = bsccs::shared_ptr<MixtureJointPrior>(
+			new MixtureJointPrior(newListPriors, newUniquePriors));
+		cloned->copyVariance(*this, copy);
+		return cloned;
+	}
+
 // 	JointPrior* clone() const {
 // 		PriorList newListPriors(listPriors.size());
 //
@@ -552,6 +614,22 @@ public:
 		return (- (gh.first + gradient)/(gh.second + hessian));
 	}
 
+	JointPriorPtr clone() const {
+		VarianceCopier copy;
+		PriorList newHierarchyPriors;
+		for (const auto& prior : hierarchyPriors) {
+			PriorPtr newPrior = prior->clone(copy);
+			if (!newPrior) {
+				return JointPriorPtr();
+			}
+			newHierarchyPriors.push_back(newPrior);
+		}
+		auto cloned = bsccs::shared_ptr<HierarchicalJointPrior>(new HierarchicalJointPrior(
+			newHierarchyPriors, hierarchyDepth, getParentMap, getChildMap));
+		cloned->copyVariance(*this, copy);
+		return cloned;
+	}
+
 // 	JointPrior* clone() const {
 // 		PriorList newHierarchyPriors;
 //
@@ -617,6 +695,14 @@ public:
 		return singlePrior->getDelta(gh, beta, index);
 	}
 
+	bool getGradientHessian(const DoubleVector& beta, const int index, GradientHessian& gh) const {
+		return singlePrior->getGradientHessian(beta, index, gh);
+	}
+
+	bool getL1Penalty(const int index, double& lambda) const {
+		return singlePrior->getL1Penalty(index, lambda);
+	}
+
 	bool getIsRegularized(const int index) const {
 	    return singlePrior->getIsRegularized();
 	}
@@ -637,6 +723,17 @@ public:
 		return singlePrior->getKktBoundary();
 	}
 
+	JointPriorPtr clone() const {
+		VarianceCopier copy;
+		PriorPtr newPrior = singlePrior->clone(copy);
+		if (!newPrior) {
+			return JointPriorPtr();
+		}
+		auto cloned = bsccs::make_shared<FullyExchangeableJointPrior>(newPrior);
+		cloned->copyVariance(*this, copy);
+		return cloned;
+	}
+
 // 	JointPrior* clone() const {
 // 	    std::vector<VariancePtr> newPtrs;
 // 	    for (auto x : variance) {
@@ -651,8 +748,6 @@ private:
 	PriorPtr singlePrior;
 };
 
-typedef bsccs::shared_ptr<JointPrior> JointPriorPtr;
-
 } /* namespace priors */
 } /* namespace bsccs */
 #endif /* JOINTPRIOR_H_ */
@@ -111,6 +111,7 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 		// Cross-validation arguments
 		SwitchArg doCVArg("c", "cv", "Perform cross-validation selection of hyperprior variance", arguments.crossValidation.doCrossValidation);
 		SwitchArg useAutoSearchCVArg("", "auto", "Use an auto-search when performing cross-validation", arguments.crossValidation.useAutoSearchCV);
+		SwitchArg useBatchSearchCVArg("", "batch", "Move all hyperprior dimensions together during auto-search", arguments.crossValidation.useBatchSearch);
 		ValueArg<double> lowerCVArg("l", "lower", "Lower limit for cross-validation search", false, arguments.crossValidation.lowerLimit, "real");
 		ValueArg<double> upperCVArg("u", "upper", "Upper limit for cross-validation search", false, arguments.crossValidation.upperLimit, "real");
 		ValueArg<int> foldCVArg("f", "fold", "Fold level for cross-validation", false, arguments.crossValidation.fold, "int");
@@ -191,6 +192,7 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 
 		cmd.add(doCVArg);
 		cmd.add(useAutoSearchCVArg);
+		cmd.add(useBatchSearchCVArg);
 		cmd.add(lowerCVArg);
 		cmd.add(upperCVArg);
 		cmd.add(foldCVArg);
@@ -282,6 +284,7 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 		arguments.crossValidation.doCrossValidation = doCVArg.isSet();
 		if (arguments.crossValidation.doCrossValidation) {
 			arguments.crossValidation.useAutoSearchCV = useAutoSearchCVArg.isSet();
+			arguments.crossValidation.useBatchSearch = useBatchSearchCVArg.isSet();
 			arguments.crossValidation.lowerLimit = lowerCVArg.getValue();
 			arguments.crossValidation.upperLimit = upperCVArg.getValue();
 			arguments.crossValidation.fold = foldCVArg.getValue();
@@ -0,0 +1,500 @@
+/*
+ * bench.cpp
+ *
+ * Micro- and macro-benchmarks for the engine on synthetic data.  Kernel timings come from the
+ * engine profiler (per phase and column format); end-to-end timings cover findMode,
+ * cross-validation and profile likelihood.  Results are written as CSV so that runs from
+ * different releases can be compared directly.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "tclap/CmdLine.h"
+
+#include "CcdInterface.h"
+#include "CyclicCoordinateDescent.h"
+#include "ModelData.h"
+#include "engine/AbstractModelSpecifics.h"
+#include "priors/JointPrior.h"
+#include "priors/CovariatePrior.h"
+#include "io/CmdLineProgressLogger.h"
+
+namespace bsccs {
+
+struct BenchArguments {
+	std::string modelName;
+	long rows;
+	int covariates;
+	double density;
+	int strataSize;
+	double denseFraction;
+	double indicatorFraction;
+	double effectSizeSd;
+	double zeroEffectSizeProp;
+	double variance;
+	int replicates;
+	int threads;
+	bool pinThreads;
+	long seed;
+	bool doCrossValidation;
+	bool doProfile;
+	std::string outFileName;
+
+	BenchArguments() :
+		modelName("lr"),
+		rows(10000),
+		covariates(100),
+		density(0.05),
+		strataSize(4),
+		denseFraction(0.0),
+		indicatorFraction(0.5),
+		effectSizeSd(1.0),
+		zeroEffectSizeProp(0.9),
+		variance(1.0),
+		replicates(10),
+		threads(1),
+		pinThreads(false),
+		seed(123),
+		doCrossValidation(false),
+		doProfile(false)
+		{ }
+};
+
+// Synthetic design in the spirit of simulateCyclopsData(); rows are emitted in the order the
+// engine expects (by stratum, and by descending time for Cox)
+class SyntheticData {
+public:
+
+	struct Column {
+		FormatType format;
+		std::vector<IdType> rows;
+		std::vector<double> values;
+	};
+
+	SyntheticData(const BenchArguments& args, ModelType modelType)
+		: engine(args.seed), stratum(args.rows, 0), y(args.rows, 0.0), time(args.rows, 1.0) {
+
+		const long N = args.rows;
+		std::normal_distribution<double> normal(0.0, 1.0);
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+		const bool conditional = modelType == ModelType::CONDITIONAL_LOGISTIC ||
+			modelType == ModelType::SELF_CONTROLLED_MODEL;
+		if (conditional) {
+			for (long i = 0; i < N; ++i) {
+				stratum[i] = i / std::max(1, args.strataSize);
+			}
+		}
+
+		const int nDense = static_cast<int>(args.denseFraction * args.covariates);
+		const int nIndicator = static_cast<int>(args.indicatorFraction * args.covariates);
+
+		std::vector<double> eta(N, 0.0);
+		std::geometric_distribution<long> gap(std::min(1.0, std::max(args.density, 1E-9)));
+
+		for (int j = 0; j < args.covariates; ++j) {
+			Column column;
+			column.format = (j < nDense) ? DENSE :
+				(j < nDense + nIndicator) ? INDICATOR : SPARSE;
+
+			const double effect = (uniform(engine) < args.zeroEffectSizeProp) ? 0.0 :
+				args.effectSizeSd * normal(engine);
+
+			if (column.format == DENSE) {
+				column.values.resize(N);
+				for (long i = 0; i < N; ++i) {
+					column.values[i] = normal(engine);
+					eta[i] += effect * column.values[i];
+				}
+			} else {
+				for (long i = gap(engine); i < N; i += 1 + gap(engine)) {
+					column.rows.push_back(i);
+					const double value = (column.format == INDICATOR) ? 1.0 : std::exp(normal(engine));
+					if (column.format == SPARSE) {
+						column.values.push_back(value);
+					}
+					eta[i] += effect * value;
+				}
+			}
+			columns.push_back(std::move(column));
+		}
+
+		simulateOutcomes(modelType, eta, args.strataSize);
+
+		if (modelType == ModelType::COX) {
+			sortByDescendingTime();
+		}
+	}
+
+	void load(ModelData<double>& data, bool addIntercept) const {
+		std::vector<IdType> rowId(y.size());
+		std::iota(std::begin(rowId), std::end(rowId), 0);
+
+		const ModelType modelType = data.getModelType();
+		const bool hasStrata = modelType == ModelType::CONDITIONAL_LOGISTIC ||
+			modelType == ModelType::SELF_CONTROLLED_MODEL || modelType == ModelType::COX;
+		const bool hasTime = modelType == ModelType::POISSON ||
+			modelType == ModelType::SELF_CONTROLLED_MODEL || modelType == ModelType::COX;
+
+		data.loadY(hasStrata ? stratum : std::vector<IdType>(), rowId, y,
+			hasTime ? time : std::vector<double>());
+
+		if (addIntercept) {
+			data.loadX(0, std::vector<IdType>(), std::vector<double>(), false, false, false);
+		}
+
+		for (size_t j = 0; j < columns.size(); ++j) {
+			const Column& column = columns[j];
+			data.loadX(j + 1, column.rows, column.values, false, false, column.format == SPARSE);
+		}
+	}
+
+private:
+
+	void simulateOutcomes(ModelType modelType, const std::vector<double>& eta, int strataSize) {
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+		const long N = eta.size();
+
+		switch (modelType) {
+		case ModelType::LOGISTIC :
+			for (long i = 0; i < N; ++i) {
+				const double p = 1.0 / (1.0 + std::exp(-(std::log(0.25) + eta[i])));
+				y[i] = uniform(engine) < p ? 1.0 : 0.0;
+			}
+			break;
+		case ModelType::POISSON :
+		case ModelType::SELF_CONTROLLED_MODEL :
+			for (long i = 0; i < N; ++i) {
+				time[i] = 1.0 + std::floor(uniform(engine) * 500.0);
+				std::poisson_distribution<int> count(0.02 * std::exp(eta[i]) * time[i]);
+				y[i] = count(engine);
+			}
+			break;
+		case ModelType::CONDITIONAL_LOGISTIC :
+			// One case per stratum, chosen with probability proportional to exp(eta)
+			for (long begin = 0; begin < N; begin += strataSize) {
+				const long end = std::min(N, begin + strataSize);
+				std::vector<double> weight(std::begin(eta) + begin, std::begin(eta) + end);
+				for (auto& w : weight) w = std::exp(w);
+				std::discrete_distribution<long> pick(std::begin(weight), std::end(weight));
+				y[begin + pick(engine)] = 1.0;
+			}
+			break;
+		case ModelType::COX :
+			for (long i = 0; i < N; ++i) {
+				std::exponential_distribution<double> event(0.02 * std::exp(eta[i]));
+				const double toEvent = 1.0 + std::round(event(engine));
+				const double toCensor = 1.0 + std::round(uniform(engine) * 499.0);
+				time[i] = std::min(toEvent, toCensor);
+				y[i] = (toCensor > toEvent) ? 1.0 : 0.0;
+			}
+			break;
+		default :
+			break;
+		}
+	}
+
+	void sortByDescendingTime() {
+		const long N = y.size();
+		std::vector<long> order(N);
+		std::iota(std::begin(order), std::end(order), 0);
+		std::stable_sort(std::begin(order), std::end(order), [this](long lhs, long rhs) {
+			return time[lhs] > time[rhs] || (time[lhs] == time[rhs] && y[lhs] < y[rhs]);
+		});
+
+		std::vector<long> rank(N);
+		for (long i = 0; i < N; ++i) {
+			rank[order[i]] = i;
+		}
+
+		permute(y, order);
+		permute(time, order);
+
+		for (auto& column : columns) {
+			if (column.format == DENSE) {
+				permute(column.values, order);
+			} else {
+				std::vector<std::pair<IdType, double>> entries;
+				for (size_t k = 0; k < column.rows.size(); ++k) {
+					entries.emplace_back(rank[column.rows[k]],
+						column.values.empty() ? 1.0 : column.values[k]);
+				}
+				std::sort(std::begin(entries), std::end(entries));
+				for (size_t k = 0; k < entries.size(); ++k) {
+					column.rows[k] = entries[k].first;
+					if (!column.values.empty()) {
+						column.values[k] = entries[k].second;
+					}
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	static void permute(std::vector<T>& vector, const std::vector<long>& order) {
+		std::vector<T> copy(vector.size());
+		for (size_t i = 0; i < order.size(); ++i) {
+			copy[i] = vector[order[i]];
+		}
+		vector.swap(copy);
+	}
+
+	std::mt19937 engine;
+
+public:
+	std::vector<IdType> stratum;
+	std::vector<double> y;
+	std::vector<double> time;
+	std::vector<Column> columns;
+};
+
+class BenchCcdInterface : public CcdInterface {
+public:
+
+	BenchCcdInterface(const BenchArguments& bench, ModelType modelType)
+		: bench(bench), modelType(modelType), modelData(nullptr) {
+		arguments.modelName = bench.modelName;
+		arguments.noiseLevel = SILENT;
+		arguments.seed = bench.seed;
+		arguments.threads = bench.threads;
+		arguments.hyperprior = bench.variance;
+		arguments.crossValidation.useAutoSearchCV = true;
+		arguments.crossValidation.selectorType = SelectorType::DEFAULT;
+		logger = bsccs::make_shared<loggers::CerrLogger>(); // Keep stdout for results
+		error = bsccs::make_shared<loggers::CerrErrorHandler>();
+	}
+
+	virtual ~BenchCcdInterface() {
+		delete modelData;
+	}
+
+	bool hasIntercept() const {
+		return modelType == ModelType::LOGISTIC || modelType == ModelType::POISSON;
+	}
+
+protected:
+
+	void initializeModelImpl(
+			AbstractModelData** outModelData,
+			CyclicCoordinateDescent** ccd,
+			AbstractModelSpecifics** model) {
+
+		modelData = new ModelData<double>(modelType, logger, error);
+		SyntheticData(bench, modelType).load(*modelData, hasIntercept());
+		*outModelData = modelData;
+
+		*model = AbstractModelSpecifics::factory(modelType, *modelData, DeviceType::CPU, "");
+		if (*model == nullptr) {
+			std::ostringstream stream;
+			stream << "Invalid model type.";
+			error->throwError(stream);
+		}
+
+		using namespace bsccs::priors;
+		PriorPtr singlePrior = std::make_shared<LaplacePrior>(bench.variance);
+		JointPriorPtr prior;
+		if (hasIntercept()) {
+			auto mixturePrior = std::make_shared<MixtureJointPrior>(
+				singlePrior, modelData->getNumberOfCovariates());
+			mixturePrior->changePrior(std::make_shared<NoPrior>(), 0);
+			prior = mixturePrior;
+		} else {
+			prior = std::make_shared<FullyExchangeableJointPrior>(singlePrior);
+		}
+
+		*ccd = new CyclicCoordinateDescent(*modelData, **model, prior, logger, error);
+		(*ccd)->setNoiseLevel(arguments.noiseLevel);
+	}
+
+	void predictModelImpl(CyclicCoordinateDescent *ccd, AbstractModelData *modelData) { }
+
+	void logModelImpl(CyclicCoordinateDescent *ccd, AbstractModelData *modelData,
+			ProfileInformationMap &profileMap, bool withProfileBounds) { }
+
+	void diagnoseModelImpl(CyclicCoordinateDescent *ccd, AbstractModelData *modelData,
+			double loadTime, double updateTime) { }
+
+private:
+	const BenchArguments& bench;
+	const ModelType modelType;
+	ModelData<double>* modelData;
+};
+
+class ResultWriter {
+public:
+
+	ResultWriter(std::ostream& stream, const BenchArguments& args) : stream(stream), args(args) {
+		stream << "benchmark,model,rows,covariates,density,threads,pinned,phase,format,calls,seconds"
+			<< std::endl;
+	}
+
+	void write(const std::string& benchmark, const std::string& phase, const std::string& format,
+			long long calls, double seconds) {
+		stream << benchmark << "," << args.modelName << "," << args.rows << ","
+			<< args.covariates << "," << args.density << "," << args.threads << ","
+			<< args.pinThreads << "," << phase << "," << format << "," << calls << "," << seconds << std::endl;
+	}
+
+	void write(const std::string& benchmark, const std::vector<Profiler::Entry>& entries) {
+		for (const auto& entry : entries) {
+			write(benchmark, entry.phase, entry.format, entry.calls, entry.nanoseconds * 1E-9);
+		}
+	}
+
+private:
+	std::ostream& stream;
+	const BenchArguments& args;
+};
+
+ModelType parseModelName(const std::string& name) {
+	if (name == "sccs") return ModelType::SELF_CONTROLLED_MODEL;
+	if (name == "clr") return ModelType::CONDITIONAL_LOGISTIC;
+	if (name == "cox") return ModelType::COX;
+	if (name == "pr") return ModelType::POISSON;
+	return ModelType::LOGISTIC;
+}
+
+void parseCommandLine(int argc, char* argv[], BenchArguments& args) {
+	using namespace TCLAP;
+	try {
+		CmdLine cmd("Cyclops engine benchmarks", ' ', "0.1");
+
+		std::vector<std::string> allowedModels = { "sccs", "clr", "cox", "lr", "pr" };
+		ValuesConstraint<std::string> allowedModelValues(allowedModels);
+		ValueArg<std::string> modelArg("m", "model", "Model type", false, args.modelName, &allowedModelValues);
+		ValueArg<long> rowsArg("N", "rows", "Number of rows", false, args.rows, "long");
+		ValueArg<int> covariatesArg("J", "covariates", "Number of covariates", false, args.covariates, "int");
+		ValueArg<double> densityArg("", "density", "Expected fraction of non-zeros per sparse/indicator column", false, args.density, "real");
+		ValueArg<int> strataSizeArg("", "strataSize", "Rows per stratum for conditional models", false, args.strataSize, "int");
+		ValueArg<double> denseArg("", "dense", "Fraction of dense columns", false, args.denseFraction, "real");
+		ValueArg<double> indicatorArg("", "indicator", "Fraction of indicator columns (remainder are sparse)", false, args.indicatorFraction, "real");
+		ValueArg<double> varianceArg("v", "variance", "Laplace prior variance", false, args.variance, "real");
+		ValueArg<int> replicatesArg("r", "replicates", "Kernel sweeps over all columns", false, args.replicates, "int");
+		ValueArg<int> threadsArg("", "threads", "Number of threads", false, args.threads, "int");
+		SwitchArg pinArg("", "pin", "Pin worker threads to fixed CPUs (Linux only)", args.pinThreads);
+		ValueArg<long> seedArg("s", "seed", "Random number generator seed", false, args.seed, "long");
+		SwitchArg cvArg("c", "cv", "Benchmark auto-search cross-validation", args.doCrossValidation);
+		SwitchArg profileArg("p", "profile", "Benchmark profile likelihood of the first covariate", args.doProfile);
+		ValueArg<std::string> outFileArg("o", "outFileName", "CSV output file name (default is stdout)", false, args.outFileName, "outFileName");
+
+		cmd.add(modelArg);
+		cmd.add(rowsArg);
+		cmd.add(covariatesArg);
+		cmd.add(densityArg);
+		cmd.add(strataSizeArg);
+		cmd.add(denseArg);
+		cmd.add(indicatorArg);
+		cmd.add(varianceArg);
+		cmd.add(replicatesArg);
+		cmd.add(threadsArg);
+		cmd.add(pinArg);
+		cmd.add(seedArg);
+		cmd.add(cvArg);
+		cmd.add(profileArg);
+		cmd.add(outFileArg);
+		cmd.parse(argc, argv);
+
+		args.modelName = modelArg.getValue();
+		args.rows = rowsArg.getValue();
+		args.covariates = covariatesArg.getValue();
+		args.density = densityArg.getValue();
+		args.strataSize = strataSizeArg.getValue();
+		args.denseFraction = denseArg.getValue();
+		args.indicatorFraction = indicatorArg.getValue();
+		args.variance = varianceArg.getValue();
+		args.replicates = replicatesArg.getValue();
+		args.threads = threadsArg.getValue();
+		args.pinThreads = pinArg.getValue();
+		args.seed = seedArg.getValue();
+		args.doCrossValidation = cvArg.getValue();
+		args.doProfile = profileArg.getValue();
+		args.outFileName = outFileArg.getValue();
+	} catch (ArgException &e) {
+		std::cerr << "Error: " << e.error() << " for argument " << e.argId() << std::endl;
+		exit(-1);
+	}
+}
+
+} // namespace bsccs
+
+int main(int argc, char* argv[]) {
+
+	using namespace bsccs;
+
+	BenchArguments args;
+	parseCommandLine(argc, argv, args);
+
+	std::ofstream outFile;
+	if (!args.outFileName.empty()) {
+		outFile.open(args.outFileName.c_str());
+	}
+	ResultWriter writer(args.outFileName.empty() ? std::cout : outFile, args);
+
+	const ModelType modelType = parseModelName(args.modelName);
+	BenchCcdInterface interface(args, modelType);
+
+	CyclicCoordinateDescent* ccd = nullptr;
+	AbstractModelSpecifics* model = nullptr;
+	AbstractModelData* modelData = nullptr;
+
+	writer.write("load", "total", "", 1, interface.initializeModel(&modelData, &ccd, &model));
+	ccd->getWorkerPool()->setAffinity(args.pinThreads);
+
+	// Kernel sweeps: each column's numerator, gradient/Hessian and a no-op xBeta update,
+	// followed by the per-sweep statistics refresh
+	ccd->getLogLikelihood(); // Initialize all lazily computed state
+	const int J = modelData->getNumberOfCovariates();
+	Profiler& profiler = model->getProfiler();
+	profiler.setEnabled(true);
+	for (int r = 0; r < args.replicates; ++r) {
+		for (int j = 0; j < J; ++j) {
+			double gradient, hessian;
+			model->computeNumeratorForGradient(j, false);
+			model->computeGradientAndHessian(j, &gradient, &hessian, false);
+			model->updateXBeta(0.0, j, false);
+		}
+		model->computeRemainingStatistics(false);
+		model->getLogLikelihood(false);
+	}
+	writer.write("kernel", profiler.getEntries());
+
+	// End-to-end mode finding
+	profiler.setEnabled(true);
+	ccd->resetBeta();
+	const double fitSeconds = interface.fitModel(ccd);
+	writer.write("findMode", ccd->getProfile());
+	writer.write("findMode", "total", "", ccd->getIterationCount(), fitSeconds);
+
+	if (args.doCrossValidation) {
+		profiler.setEnabled(false);
+		ccd->resetBeta();
+		interface.getArguments().crossValidation.doCrossValidation = true;
+		writer.write("cv", "total", "", 1, interface.runCrossValidation(ccd, modelData));
+		ccd->setHyperprior(args.variance);
+	}
+
+	if (args.doProfile) {
+		profiler.setEnabled(false);
+		ccd->resetBeta();
+		interface.fitModel(ccd);
+		ProfileVector profileCI = { 1 };
+		ProfileInformationMap profileMap;
+		writer.write("profile", "total", "", profileCI.size(),
+			interface.profileModel(ccd, modelData, profileCI, profileMap, args.threads,
+				1.920729, true /* overrideNoRegularization */));
+	}
+
+	delete ccd;
+	delete model;
+
+	return 0;
+}
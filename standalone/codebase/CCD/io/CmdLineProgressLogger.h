@@ -30,6 +30,20 @@ private:
     std::mutex lock;    
 };
 
+class CerrLogger : public ProgressLogger {
+public:
+    void writeLine(const std::ostringstream& stream) {
+        lock.lock();
+        std::cerr << stream.str() << std::endl;
+        lock.unlock();
+    }
+
+    void yield() { } // Do nothing
+
+private:
+    std::mutex lock;
+};
+
 class CerrErrorHandler : public ErrorHandler {
 public:
     void throwError(const std::ostringstream& stream) {
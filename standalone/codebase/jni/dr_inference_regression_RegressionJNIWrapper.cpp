@@ -49,6 +49,32 @@ JNIEXPORT jdouble JNICALL Java_dr_inference_regression_RegressionJNIWrapper_getL
  	return instances[instance].ccd->getLogLikelihood(); 
 }
 
+extern "C"
+JNIEXPORT jdouble JNICALL Java_dr_inference_regression_RegressionJNIWrapper_getLogLikelihoodGradient
+  (JNIEnv *env, jobject obj, jint instance, jdoubleArray outGradient) {
+	std::vector<double> gradient;
+	double logLikelihood = instances[instance].ccd->getLogLikelihoodGradient(gradient);
+	if (!gradient.empty()) {
+		env->SetDoubleArrayRegion( outGradient, 0, gradient.size(), &gradient[0] );
+	}
+	return logLikelihood;
+}
+
+extern "C"
+JNIEXPORT void JNICALL Java_dr_inference_regression_RegressionJNIWrapper_getHessianVectorProduct
+  (JNIEnv *env, jobject obj, jint instance, jdoubleArray inVector, jdoubleArray outProduct) {
+	jsize size = env->GetArrayLength( inVector );
+	std::vector<double> input( size );
+	if (size > 0) {
+		env->GetDoubleArrayRegion( inVector, 0, size, &input[0] );
+	}
+	std::vector<double> product;
+	instances[instance].ccd->getLogLikelihoodHessianVectorProduct(input, product);
+	if (!product.empty()) {
+		env->SetDoubleArrayRegion( outProduct, 0, product.size(), &product[0] );
+	}
+}
+
 extern "C"
 JNIEXPORT jdouble JNICALL Java_dr_inference_regression_RegressionJNIWrapper_getLogPrior
   (JNIEnv *env, jobject obj, jint instance) {
@@ -29,6 +29,22 @@ JNIEXPORT jint JNICALL Java_dr_inference_regression_RegressionJNIWrapper_loadDat
 JNIEXPORT jdouble JNICALL Java_dr_inference_regression_RegressionJNIWrapper_getLogLikelihood
   (JNIEnv *, jobject, jint);
 
+/*
+ * Class:     dr_inference_regression_RegressionJNIWrapper
+ * Method:    getLogLikelihoodGradient
+ * Signature: (I[D)D
+ */
+JNIEXPORT jdouble JNICALL Java_dr_inference_regression_RegressionJNIWrapper_getLogLikelihoodGradient
+  (JNIEnv *, jobject, jint, jdoubleArray);
+
+/*
+ * Class:     dr_inference_regression_RegressionJNIWrapper
+ * Method:    getHessianVectorProduct
+ * Signature: (I[D[D)V
+ */
+JNIEXPORT void JNICALL Java_dr_inference_regression_RegressionJNIWrapper_getHessianVectorProduct
+  (JNIEnv *, jobject, jint, jdoubleArray, jdoubleArray);
+
 /*
  * Class:     dr_inference_regression_RegressionJNIWrapper
  * Method:    getLogPrior